@@ -0,0 +1,3 @@
+// Copyright © 2026 Giorgio Audrito. All Rights Reserved.
+
+#include "lib/adaptive_batch.hpp"
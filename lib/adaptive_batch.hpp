@@ -0,0 +1,189 @@
+// Copyright © 2026 Giorgio Audrito. All Rights Reserved.
+
+/**
+ * @file adaptive_batch.hpp
+ * @brief Batch execution of simulations with an adaptive number of random seeds per parameter point.
+ */
+
+#ifndef FCPP_ADAPTIVE_BATCH_H_
+#define FCPP_ADAPTIVE_BATCH_H_
+
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "lib/common/tagged_tuple.hpp"
+#include "lib/component/base.hpp"
+
+
+/**
+ * @brief Namespace containing all the objects in the FCPP library.
+ */
+namespace fcpp {
+
+
+//! @brief Namespace containing tools for batch execution of simulations.
+namespace batch {
+
+
+//! @brief Criterion for stopping adding seeds to a parameter point.
+struct seed_criterion {
+    //! @brief The number of seeds run before checking the confidence interval.
+    size_t min_seeds = 3;
+    //! @brief The maximum number of seeds (as in a fixed grid).
+    size_t max_seeds = 10;
+    //! @brief The number of seeds added at a time while the confidence interval is too wide.
+    size_t step = 1;
+    //! @brief The target half-width of the 95% confidence interval, as absolute value.
+    double abs_width = 0;
+    //! @brief The target half-width of the 95% confidence interval, relative to the absolute value of the mean.
+    double rel_width = 0.05;
+};
+
+
+//! @brief Summary of an adaptive batch execution.
+struct seed_report {
+    //! @brief The number of parameter points.
+    size_t points = 0;
+    //! @brief The number of runs performed.
+    size_t runs = 0;
+    //! @brief The number of runs of the fixed grid (every point with the maximum number of seeds).
+    size_t fixed_runs = 0;
+    //! @brief The number of points stopped before the maximum number of seeds.
+    size_t converged = 0;
+
+    //! @brief Prints the report on a given stream.
+    friend std::ostream& operator<<(std::ostream& o, seed_report const& r) {
+        o << "adaptive seeds: " << r.runs << " runs instead of " << r.fixed_runs << " over " << r.points << " points";
+        o << " (" << r.fixed_runs - r.runs << " saved, " << 100.0 * (r.fixed_runs - r.runs) / std::max<size_t>(r.fixed_runs, 1) << "%), ";
+        return o << r.converged << " points converged before the maximum number of seeds";
+    }
+};
+
+
+//! @cond INTERNAL
+namespace details {
+    //! @brief The 97.5% quantile of the Student t distribution with given degrees of freedom.
+    inline double student_t975(size_t df) {
+        static const double t[] = {0, 12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228, 2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086};
+        if (df == 0) return INFINITY;
+        return df <= 20 ? t[df] : 1.960 + 2.4 / df;
+    }
+
+    //! @brief Running mean and variance of the statistic of a parameter point (Welford).
+    struct seed_stats {
+        //! @brief The number of seeds scheduled.
+        size_t scheduled = 0;
+        //! @brief The number of seeds completed.
+        size_t count = 0;
+        //! @brief The running mean.
+        double mean = 0;
+        //! @brief The running sum of squared deviations.
+        double m2 = 0;
+
+        //! @brief Adds a value.
+        void insert(double x) {
+            ++count;
+            double d = x - mean;
+            mean += d / count;
+            m2 += d * (x - mean);
+        }
+
+        //! @brief The half-width of the 95% confidence interval of the mean.
+        double width() const {
+            if (count < 2) return INFINITY;
+            return student_t975(count - 1) * std::sqrt(m2 / (count - 1) / count);
+        }
+    };
+
+    //! @brief Appends a seed to an output file name, before its extension.
+    inline std::string seeded_name(std::string name, size_t seed) {
+        size_t i = name.rfind('.');
+        size_t j = name.rfind('/');
+        if (i == std::string::npos or (j != std::string::npos and i < j)) i = name.size();
+        return name.insert(i, "-seed" + std::to_string(seed));
+    }
+
+    //! @brief Appends a seed to an output file name (no file overload).
+    template <typename T>
+    inline T seeded_name(T name, size_t) {
+        return name;
+    }
+}
+//! @endcond
+
+
+/**
+ * @brief Runs a sequence of parameter points with an adaptive number of seeds, returning a summary.
+ *
+ * Every element of the sequence is a parameter point, whose `seed` tag is overwritten with the seeds run
+ * (and whose `output` file name, if any, gets the seed appended). After a run, a statistic is computed by
+ * `stat` from the network object, and further seeds are scheduled for the point as long as the confidence
+ * interval of the mean statistic is wider than the target. Runs are distributed dynamically among threads.
+ */
+template <typename T, typename S, typename F>
+seed_report adaptive_run(T, S const& seq, seed_criterion const& c, F&& stat, size_t threads = std::thread::hardware_concurrency()) {
+    std::vector<details::seed_stats> stats(seq.size());
+    std::deque<std::pair<size_t, size_t>> queue;
+    std::mutex m;
+    std::condition_variable cv;
+    size_t active = 0;
+    seed_report report;
+    report.points = seq.size();
+    report.fixed_runs = seq.size() * c.max_seeds;
+    for (size_t i = 0; i < seq.size(); ++i)
+        for (; stats[i].scheduled < std::min(c.min_seeds, c.max_seeds); ++stats[i].scheduled)
+            queue.emplace_back(i, stats[i].scheduled);
+    auto worker = [&](){
+        std::unique_lock<std::mutex> lock(m);
+        while (true) {
+            cv.wait(lock, [&](){
+                return not queue.empty() or active == 0;
+            });
+            if (queue.empty()) return;
+            std::pair<size_t, size_t> job = queue.front();
+            queue.pop_front();
+            ++active;
+            lock.unlock();
+            auto t = seq[job.first];
+            common::get<component::tags::seed>(t) = job.second;
+            common::get<component::tags::output>(t) = details::seeded_name(common::get<component::tags::output>(t), job.second);
+            double x;
+            {
+                typename T::net network{t};
+                network.run();
+                x = stat(network);
+            }
+            lock.lock();
+            --active;
+            ++report.runs;
+            details::seed_stats& s = stats[job.first];
+            s.insert(x);
+            if (s.count == s.scheduled and s.scheduled < c.max_seeds and s.width() > std::max(c.abs_width, c.rel_width * std::abs(s.mean)))
+                for (size_t k = 0; k < c.step and s.scheduled < c.max_seeds; ++k, ++s.scheduled)
+                    queue.emplace_front(job.first, s.scheduled);
+            cv.notify_all();
+        }
+    };
+    std::vector<std::thread> pool;
+    for (size_t i = 1; i < threads; ++i) pool.emplace_back(worker);
+    worker();
+    for (std::thread& t : pool) t.join();
+    for (details::seed_stats const& s : stats) report.converged += s.count < c.max_seeds;
+    return report;
+}
+
+
+} // namespace batch
+
+
+} // namespace fcpp
+
+#endif // FCPP_ADAPTIVE_BATCH_H_
@@ -0,0 +1,3 @@
+// Copyright © 2023 Gianmarco Rampulla. All Rights Reserved.
+
+#include "lib/apartment_walk.hpp"
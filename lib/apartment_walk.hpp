@@ -0,0 +1,255 @@
+// Copyright © 2023 Gianmarco Rampulla. All Rights Reserved.
+
+/**
+ * @file apartment_walk.hpp
+ * @brief Minimal experiment for the navigator component.
+ *
+ * This header file is designed to work both interactively and in batch runs with many people.
+ */
+
+#ifndef FCPP_APARTMENT_WALK_H_
+#define FCPP_APARTMENT_WALK_H_
+
+#include <string>
+#include <type_traits>
+
+#include "lib/fcpp.hpp"
+#include "lib/nearest_hood.hpp"
+#include "lib/obstacle_cache.hpp"
+
+/**
+ * @brief Namespace containing all the objects in the FCPP library.
+ */
+namespace fcpp {
+
+//! @brief Dummy ordering between positions (allows positions to be used as secondary keys in ordered tuples).
+template <size_t n>
+bool operator<(vec<n> const& a, vec<n> const& b) {
+    for(int i = 0; i < n; i++)
+        if (a[i] >= b[i]) return  false;
+    return true;
+}
+
+//! @brief Dimensionality of the space.
+constexpr size_t dim = 3;
+//! @brief Side of the deployment area.
+constexpr size_t width = 850;
+//! @brief Height of the deployment area.
+constexpr size_t height = 500;
+//! @brief Tallness of the deployment area.
+constexpr size_t tall = 50;
+//! @brief The floor plan image.
+constexpr char const* floor_plan_image = "apartment.jpg";
+//! @brief Color threshold of obstacles in the floor plan image.
+constexpr real_t obstacle_threshold = 0.8;
+//! @brief Distance within which people repel each other.
+constexpr real_t repulsion_radius = 25;
+//! @brief The final simulation time (in batch runs).
+constexpr size_t end_time = 20;
+
+//! @brief Namespace containing the libraries of coordination routines.
+namespace coordination {
+
+//! @brief Tags used in the node storage.
+namespace tags {
+    //! @brief Color of the current node.
+    struct node_color {};
+    //! @brief Size of the current node.
+    struct node_size {};
+    //! @brief Shape of the current node.
+    struct node_shape {};
+    //! @brief Speed of the current node
+    struct speed {};
+    //! @brief Coordinates of nearest obstacle
+    struct nearest_obstacle {};
+    //! @brief Distance from nearest obstacle
+    struct distance_from_obstacle {};
+    //! @brief Delta X from nearest obstacle
+    struct obstacle_delta_x {};
+    //! @brief Delta Y from nearest obstacle
+    struct obstacle_delta_y {};
+    //! @brief Distance from closest neighbour
+    struct distance_min_nbr {};
+    //! @brief Number of neighbours (including the node itself)
+    struct nbr_count {};
+    //! @brief Total number of neighbours over all rounds
+    struct nbr_total {};
+    //! @brief Number of rounds performed
+    struct round_count {};
+    //! @brief Number of people in the area (in batch runs)
+    struct people {};
+}
+
+
+//! @brief The cache of the obstacle map of the floor plan, with a unit cell (in the `output/cache` directory).
+inline obstacle_cache<dim>& floor_plan_cache() {
+    static obstacle_cache<dim> c("output/cache", std::string("textures/") + floor_plan_image, obstacle_threshold, {0, 0}, {width, height}, 1);
+    return c;
+}
+
+/**
+ * @brief The obstacle map of the floor plan, from the cache or sampled from the simulated map at the first call.
+ *
+ * Obstacle queries on the map cost a constant number of lookups, through the nearest obstacle and free space of
+ * every cell computed once. The map is shared by all networks in the process, which all load the same floor plan.
+ */
+template <typename node_t>
+obstacle_map<dim> const& floor_plan(node_t& node) {
+    static obstacle_map<dim> const& m = floor_plan_cache().map([&](real_t x, real_t y){
+        return node.net.is_obstacle(make_vec(x, y, tall));
+    });
+    return m;
+}
+
+
+//! @brief Main function.
+MAIN() {
+    node.storage(tags::node_size{}) = 10;
+    node.storage(tags::node_color{}) = color(TAN);
+    node.storage(tags::node_shape{}) = shape::sphere;
+
+    obstacle_map<dim> const& map = floor_plan(node);
+
+    // used to set position of out of bound nodes at the start
+    if (coordination::counter(CALL) == 1) {
+        if (map.is_obstacle(node.position())) {
+            auto p2 = map.closest_space(node.position());
+            int deltaX, deltaY, size = node.storage(tags::node_size{});
+            if((p2 - node.position())[0] > 0) deltaX = +size; else deltaX = -size;
+            if((p2 - node.position())[1] > 0) deltaY = +size; else deltaY = -size;
+            node.position() = make_vec(p2[0] + deltaX, p2[1] + deltaY, tall);
+        }
+    }
+
+    auto closest = map.closest_obstacle(node.position());
+    real_t dist1 = distance(closest, node.position());
+    // the closest distance and the springs towards every neighbour, in a single pass
+    auto nearest = nearest_hood<dim>(CALL, 0.05, 0.05);
+    real_t min_neighbor_dist = nearest.closest();
+
+    node.storage(tags::nearest_obstacle{}) = closest;
+    node.storage(tags::distance_from_obstacle{}) = dist1;
+    node.storage(tags::distance_min_nbr{}) = min_neighbor_dist;
+    node.storage(tags::nbr_count{}) = count_hood(CALL);
+    node.storage(tags::nbr_total{}) += node.storage(tags::nbr_count{});
+    node.storage(tags::round_count{}) += 1;
+
+    if (dist1 <= 30) {
+        node.velocity() = make_vec(0,0,0);
+        node.propulsion() = make_vec(0,0,0);
+        node.propulsion() += -coordination::point_elastic_force(CALL,closest,1,0.10);
+        if (min_neighbor_dist <= repulsion_radius) {
+            node.velocity() = make_vec(0,0,0);
+            node.propulsion() += -nearest.elastic_force();
+        }
+    }
+    else {
+        if (min_neighbor_dist <= repulsion_radius) {
+            node.propulsion() = make_vec(0,0,0);
+            node.velocity() = make_vec(0,0,0);
+            node.propulsion() += -nearest.elastic_force();
+        }
+        else {
+            node.propulsion() = make_vec(0,0,0);
+            rectangle_walk(CALL, make_vec(0, 0, tall), make_vec(width, height, tall), node.storage(tags::speed{}), 1);
+        }
+    }
+}
+//! @brief Export types used by the main function (update it when expanding the program).
+FUN_EXPORT main_t = common::export_list<double, int, rectangle_walk_t<dim>, nearest_hood_t>;
+
+} // namespace coordination
+
+// [SYSTEM SETUP]
+
+//! @brief Namespace for component options.
+namespace option {
+
+//! @brief Import tags to be used for component options.
+using namespace component::tags;
+//! @brief Import tags used by aggregate functions.
+using namespace coordination::tags;
+
+using fcpp::dim;
+using fcpp::width;
+using fcpp::height;
+
+//! @brief Number of people in the area (in interactive runs).
+constexpr int node_num = 10;
+
+//! @brief Description of the round schedule.
+using round_s = sequence::periodic<
+    distribution::interval_n<times_t, 0, 1>,    // uniform time in the [0,1] interval for start
+    distribution::weibull_n<times_t, 10, 1, 10> // weibull-distributed time for interval (10/10=1 mean, 1/10=0.1 deviation)
+>;
+//! @brief Description of the round schedule in batch runs (ending after end_time).
+using batch_round_s = sequence::periodic<
+    distribution::interval_n<times_t, 0, 1>,
+    distribution::weibull_n<times_t, 10, 1, 10>,
+    distribution::constant_n<times_t, end_time+2>
+>;
+//! @brief The sequence of network snapshots (one every simulated second).
+using log_s = sequence::periodic_n<1, 0, 1>;
+//! @brief The sequence of network snapshots in batch runs (one every simulated second until end_time).
+using batch_log_s = sequence::periodic_n<1, 0, 1, end_time>;
+//! @brief The sequence of node generation events (node_num devices all generated at time 0).
+using spawn_s = sequence::multiple_n<node_num, 0>;
+//! @brief The sequence of node generation events in batch runs (the globally provided number of people, all generated at time 0).
+using batch_spawn_s = sequence::multiple<
+    distribution::constant_i<size_t, people>,
+    distribution::constant_n<double, 0>
+>;
+//! @brief The distribution of initial node positions (random in a 850x500 square).
+using rectangle_d = distribution::rect_n<1, 0, 0, tall, width, height, tall>;
+//! @brief The distribution of node speeds (all equal to a fixed value).
+using speed_d = distribution::constant_i<double, speed>;
+//! @brief The contents of the node storage as tags and associated types.
+using store_t = tuple_store<
+    nearest_obstacle,           vec<dim>,
+    distance_from_obstacle,     real_t,
+    obstacle_delta_x,           real_t,
+    obstacle_delta_y,           real_t,
+    distance_min_nbr,           real_t,
+    nbr_count,                  int,
+    nbr_total,                  size_t,
+    round_count,                size_t,
+    speed,                      double,
+    node_color,                 color,
+    node_size,                  double,
+    node_shape,                 shape
+>;
+//! @brief The tags and corresponding aggregators to be logged (change as needed).
+using aggregator_t = aggregators<
+    node_size,                  aggregator::mean<double>
+>;
+
+//! @brief The general simulation options, interactive or in batch runs, with multithreading on node rounds or not.
+template <bool batch = false, bool threaded = true>
+DECLARE_OPTIONS(list,
+    parallel<threaded>,  // whether to use multithreading on node rounds
+    synchronised<false>, // optimise for asynchronous networks
+    program<coordination::main>,   // program to be run (refers to MAIN above)
+    exports<coordination::main_t>, // export type list (types used in messages)
+    retain<metric::retain<2,1>>,   // messages are kept for 2 seconds before expiring
+    round_schedule<std::conditional_t<batch, batch_round_s, round_s>>, // the sequence generator for round events on nodes
+    log_schedule<std::conditional_t<batch, batch_log_s, log_s>>,       // the sequence generator for log events on the network
+    spawn_schedule<std::conditional_t<batch, batch_spawn_s, spawn_s>>, // the sequence generator of node creation events on the network
+    store_t,       // the contents of the node storage
+    aggregator_t,  // the tags and corresponding aggregators to be logged
+    init<
+        x,     rectangle_d, // initialise position randomly in a rectangle for new nodes
+        speed, speed_d
+    >,
+    dimension<dim>, // dimensionality of the space
+    connector<connect::fixed<100, 1, dim>>, // connection allowed within a fixed comm range
+    shape_tag<node_shape>, // the shape of a node is read from this tag in the store
+    size_tag<node_size>,   // the size  of a node is read from this tag in the store
+    color_tag<node_color>,  // the color of a node is read from this tag in the store
+    area<0,0,width,height>
+);
+
+} // namespace option
+
+} // namespace fcpp
+
+#endif // FCPP_APARTMENT_WALK_H_
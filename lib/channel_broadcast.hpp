@@ -3,14 +3,17 @@
 /**
  * @file channel_broadcast.hpp
  * @brief Broadcasting information through an elliptical channel.
+ *
+ * Rounds follow a fixed schedule, or an adaptive one stretching round intervals while values are stable.
  */
 
 #ifndef FCPP_CHANNEL_BROADCAST_H_
 #define FCPP_CHANNEL_BROADCAST_H_
 
-#include "lib/beautify.hpp"
-#include "lib/coordination.hpp"
-#include "lib/data.hpp"
+#include <type_traits>
+
+#include "lib/fcpp.hpp"
+#include "lib/position_oracle.hpp"
 
 
 /**
@@ -45,6 +48,21 @@ constexpr size_t height = 100;
 //! @brief Color hue scale.
 constexpr float hue_scale = 360.0f/(side+height);
 
+//! @brief Dimensionality of the space.
+constexpr size_t dim = 3;
+
+//! @brief Width of the channel.
+constexpr double channel_width = 20;
+
+//! @brief Maximum factor by which round intervals are stretched in the adaptive schedule.
+constexpr size_t max_stretch = 4;
+
+//! @brief Relative change of distances (to the distance or the communication radius, whichever larger) regarded as stable.
+constexpr double stable_tolerance = 0.05;
+
+//! @brief The final simulation time (in batch runs).
+constexpr size_t end_time = 200;
+
 
 //! @brief Namespace containing the libraries of coordination routines.
 namespace coordination {
@@ -68,6 +86,30 @@ namespace tags {
 
 //! @brief Shape of the current node.
     struct node_shape {};
+
+    //! @brief Whether the node is in the true channel (at its last round).
+    struct channel_truth {};
+
+    //! @brief Factor by which the round interval of the node is stretched.
+    struct round_stretch {};
+
+    //! @brief Number of rounds performed by the node.
+    struct round_count {};
+
+    //! @brief Total number of messages received by the node (each once, at the first round after being sent).
+    struct nbr_total {};
+
+    //! @brief Time during which the channel output of the node differed from the true channel.
+    struct error_time {};
+
+    //! @brief Time during which the channel output of the node was compared with the true channel.
+    struct tracked_time {};
+
+    //! @brief Oracle of the position of the source node.
+    struct source_oracle {};
+
+    //! @brief Oracle of the position of the destination node.
+    struct dest_oracle {};
 }
 
 
@@ -87,18 +129,193 @@ FUN bool channel(ARGS, bool source, bool dest, double width) { CODE
 //! @brief Exports for the channel function.
 FUN_EXPORT channel_t = common::export_list<bis_distance_t, broadcast_t<double, double>>;
 
-//! @brief Main function.
-MAIN() {
+//! @brief Accumulates the time during which the channel output held by the node differed from the true channel.
+FUN void channel_error(ARGS, bool held, device_t src_id, device_t dst_id) { CODE
+    // the true channel, from the positions of source and destination (computed once per quantum by the shared oracles)
+    // the endpoints are always in the channel and do not query the oracles, so they never wait on each other's lock
+    bool truth = true;
+    if (node.uid != src_id and node.uid != dst_id) {
+        vec<dim> s = oracle_position(node, node.storage(tags::source_oracle{}), src_id);
+        vec<dim> d = oracle_position(node, node.storage(tags::dest_oracle{}), dst_id);
+        truth = distance(node.position(), s) + distance(node.position(), d) < distance(s, d) + channel_width;
+    }
+    // the output held since the previous round is compared with the truth at both ends of the interval
+    if (node.storage(tags::round_count{}) > 0) {
+        times_t dt = node.current_time() - node.previous_time();
+        node.storage(tags::error_time{}) += dt * ((held != node.storage(tags::channel_truth{})) + (held != truth)) / 2.0;
+        node.storage(tags::tracked_time{}) += dt;
+    }
+    node.storage(tags::channel_truth{}) = truth;
+}
+//! @brief Exports for the channel_error function (none).
+FUN_EXPORT channel_error_t = common::export_list<>;
+
+/**
+ * @brief Counts the messages received from neighbours since the previous round of the node.
+ *
+ * Every neighbour shares the time of its round, so that messages retained across rounds (as with the adaptive
+ * schedule) are counted once, as with messages used once.
+ */
+FUN size_t fresh_messages(ARGS) { CODE
+    times_t last = node.previous_time();
+    return fold_hood(CALL, [&](times_t t, size_t c){
+        return c + (t > last);
+    }, nbr(CALL, node.current_time()), size_t(0));
+}
+//! @brief Exports for the fresh_messages function.
+FUN_EXPORT fresh_messages_t = common::export_list<times_t>;
+
+/**
+ * @brief Stretches the round interval of the node while its values and those of its neighbours are stable.
+ *
+ * Every node shares whether its values changed in its last round. The interval doubles at every round with no
+ * change in the node and its neighbours (up to `max_stretch` times the interval of the round schedule), and snaps
+ * back to the base one at the first change.
+ */
+FUN void stable_stretch(ARGS, bool changed) { CODE
+    bool disturbed = any_hood(CALL, nbr(CALL, changed), changed);
+    double& stretch = node.storage(tags::round_stretch{});
+    stretch = disturbed ? 1 : min(2 * stretch, double(max_stretch));
+    node.frequency(1 / stretch);
+}
+//! @brief Exports for the stable_stretch function.
+FUN_EXPORT stable_stretch_t = common::export_list<bool>;
+
+//! @brief Whether a distance changed beyond the stable tolerance.
+inline bool distance_changed(double prev, double curr) {
+    if (prev == curr) return false;
+    return not (abs(curr - prev) <= stable_tolerance * max(max(prev, curr), double(comm)));
+}
+
+
+//! @brief Main function, with a fixed or adaptive round schedule, measuring messages and errors in batch runs only.
+template <bool adaptive, bool batch = false>
+struct channel_main {
+    //! @brief Executes a round on a node.
+    template <typename node_t>
+    void operator()(node_t& node, times_t);
+};
+
+//! @brief Main function (with a fixed round schedule).
+using main = channel_main<false>;
+
+template <bool adaptive, bool batch>
+template <typename node_t>
+void channel_main<adaptive, batch>::operator()(node_t& node, times_t) {
     rectangle_walk(CALL, make_vec(0,0,0), make_vec(side,side,height), 10, 1);
     device_t src_id = 0;
     device_t dst_id = 1;
     bool is_src = node.uid == src_id;
     bool is_dst = node.uid == dst_id;
-    channel(CALL, is_src, is_dst, 20);
+    // the values held since the previous round
+    bool held = node.storage(tags::in_channel{});
+    double ds = node.storage(tags::source_distance{});
+    double dd = node.storage(tags::dest_distance{});
+    bool c = channel(CALL, is_src, is_dst, channel_width);
     node.storage(tags::size{}) = is_src or is_dst ? 30 : 10;
+    if (batch) channel_error(CALL, held, src_id, dst_id);
+    if (adaptive) {
+        bool changed = c != held or is_src or is_dst or node.storage(tags::round_count{}) == 0;
+        changed = changed or distance_changed(ds, node.storage(tags::source_distance{}));
+        changed = changed or distance_changed(dd, node.storage(tags::dest_distance{}));
+        stable_stretch(CALL, changed);
+    }
+    node.storage(tags::round_count{}) += 1;
+    if (batch) node.storage(tags::nbr_total{}) += fresh_messages(CALL);
+}
+//! @brief Exports for the main function (with a fixed or adaptive round schedule).
+template <bool adaptive>
+using channel_main_t = common::export_list<rectangle_walk_t<3>, channel_t, channel_error_t, fresh_messages_t, std::conditional_t<adaptive, stable_stretch_t, common::export_list<>>>;
+//! @brief Exports for the main function (with a fixed round schedule).
+FUN_EXPORT main_t = channel_main_t<false>;
+
+
 }
-//! @brief Exports for the main function.
-FUN_EXPORT main_t = common::export_list<rectangle_walk_t<3>, channel_t>;
+
+
+//! @brief Namespace for component options.
+namespace option {
+
+
+//! @brief Import tags to be used for component options.
+using namespace component::tags;
+//! @brief Import tags used by aggregate functions.
+using namespace coordination::tags;
+
+
+//! @brief The randomised sequence of rounds for every node (about one every second, with 10% variance).
+using round_s = sequence::periodic<
+    distribution::interval_n<times_t, 0, 1>,
+    distribution::weibull_n<times_t, 10, 1, 10>
+>;
+//! @brief The sequence of rounds in batch runs (ending after end_time).
+using batch_round_s = sequence::periodic<
+    distribution::interval_n<times_t, 0, 1>,
+    distribution::weibull_n<times_t, 10, 1, 10>,
+    distribution::constant_n<times_t, end_time+2>
+>;
+//! @brief The sequence of network snapshots (one every simulated second).
+using log_s = sequence::periodic_n<1, 0, 1>;
+//! @brief The sequence of network snapshots in batch runs (one every simulated second until end_time).
+using batch_log_s = sequence::periodic_n<1, 0, 1, end_time>;
+//! @brief The distribution of initial node positions (random in the deployment area).
+using rectangle_d = distribution::rect_n<1, 0, 0, 0, side, side, height>;
+//! @brief The distribution of source oracles (all sharing the globally provided one).
+using source_oracle_d = distribution::constant_i<std::shared_ptr<position_oracle<dim>>, source_oracle>;
+//! @brief The distribution of destination oracles (all sharing the globally provided one).
+using dest_oracle_d = distribution::constant_i<std::shared_ptr<position_oracle<dim>>, dest_oracle>;
+//! @brief The tags and corresponding aggregators to be logged.
+using aggregator_t = aggregators<in_channel, aggregator::mean<double>>;
+//! @brief A plot of the fraction of nodes in the channel by time.
+using plot_t = plot::split<plot::time, plot::values<aggregator_t, common::type_sequence<>, in_channel>>;
+
+/**
+ * @brief The general simulation options, with a fixed or adaptive round schedule, interactive or in batch runs.
+ *
+ * With the adaptive schedule, messages are retained long enough for the longest round interval. Batch runs
+ * measure messages and errors, with the oracles of source and destination positions provided at initialisation.
+ */
+template <bool adaptive = false, bool batch = false>
+DECLARE_OPTIONS(list,
+    parallel<true>,
+    synchronised<false>,
+    program<coordination::channel_main<adaptive, batch>>,
+    exports<coordination::channel_main_t<adaptive>>,
+    retain<std::conditional_t<adaptive, metric::retain<max_stretch+2, 1>, metric::once>>,
+    round_schedule<std::conditional_t<batch, batch_round_s, round_s>>,
+    log_schedule<std::conditional_t<batch, batch_log_s, log_s>>,
+    spawn_schedule<sequence::multiple_n<devices, 0>>,
+    tuple_store<
+        in_channel,         bool,
+        source_distance,    double,
+        dest_distance,      double,
+        distance_c,         color,
+        size,               double,
+        node_shape,         shape,
+        channel_truth,      bool,
+        round_stretch,      double,
+        round_count,        size_t,
+        nbr_total,          size_t,
+        error_time,         double,
+        tracked_time,       double,
+        source_oracle,      std::shared_ptr<position_oracle<dim>>,
+        dest_oracle,        std::shared_ptr<position_oracle<dim>>
+    >,
+    aggregator_t,
+    std::conditional_t<batch, init<
+        x,                  rectangle_d,
+        source_oracle,      source_oracle_d,
+        dest_oracle,        dest_oracle_d
+    >, init<
+        x,                  rectangle_d
+    >>,
+    plot_type<plot_t>,
+    dimension<dim>,
+    connector<connect::fixed<comm, 1, dim>>,
+    shape_tag<node_shape>,
+    size_tag<size>,
+    color_tag<distance_c>
+);
 
 
 }
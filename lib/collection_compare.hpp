@@ -8,9 +8,12 @@
 #ifndef FCPP_COLLECTION_COMPARE_H_
 #define FCPP_COLLECTION_COMPARE_H_
 
+#include <memory>
+
 #include "lib/beautify.hpp"
 #include "lib/coordination.hpp"
 #include "lib/data.hpp"
+#include "lib/position_oracle.hpp"
 
 
 /**
@@ -38,6 +41,9 @@ namespace tags {
     struct wmpc_max {};
     struct ideal_max {};
     //! @}
+
+    //! @brief Oracle of true source positions (shared by the network, none for direct access).
+    struct oracle {};
 }
 
 
@@ -75,9 +81,7 @@ FUN_EXPORT device_counting_t = common::export_list<sp_collection_t<double, doubl
 
 //! @brief Progress tracking case study.
 FUN void progress_tracking(ARGS, bool is_source, device_t source_id, double dist) { CODE
-    vec<2> source_pos = node.position();
-    if (node.net.node_count(source_id))
-        source_pos = node.net.node_at(source_id).position(node.current_time());
+    vec<2> source_pos = oracle_position(node, node.storage(tags::oracle{}), source_id);
     double value = distance(node.position(), source_pos) + (500 - node.current_time());
     double threshold = 3.5 / count_hood(CALL);
     
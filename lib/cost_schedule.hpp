@@ -0,0 +1,434 @@
+// Copyright © 2026 Giorgio Audrito. All Rights Reserved.
+
+/**
+ * @file cost_schedule.hpp
+ * @brief Batch execution of simulations in longest-processing-time order, according to a cost model learned from timings.
+ */
+
+#ifndef FCPP_COST_SCHEDULE_H_
+#define FCPP_COST_SCHEDULE_H_
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifdef FCPP_MPI
+#include <mpi.h>
+#endif
+
+#include "lib/common/tagged_tuple.hpp"
+#include "lib/component/base.hpp"
+#include "lib/plot_reduce.hpp"
+
+
+/**
+ * @brief Namespace containing all the objects in the FCPP library.
+ */
+namespace fcpp {
+
+
+//! @brief Namespace containing tools for batch execution of simulations.
+namespace batch {
+
+
+/**
+ * @brief Linear model of the cost of a run in seconds, as a non-negative combination of `N` features of the run.
+ *
+ * Features are user-supplied formulas of the parameters of a run (e.g. `devices² × end_time` for the pairwise
+ * interactions and `devices × end_time` for the per-device work). Weights start from given values, and are refit
+ * by least squares on every timing learned. Thread-safe.
+ */
+template <size_t N>
+class cost_model {
+  public:
+    //! @brief The type of feature vectors.
+    using features_type = std::array<double, N>;
+
+    //! @brief Constructor given the initial weights (all ones by default).
+    cost_model(features_type weights = uniform(1)) : m_weights(weights), m_a{}, m_b(uniform(0)) {}
+
+    //! @brief The estimated cost of a run with given features.
+    double estimate(features_type const& x) const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        double c = 0;
+        for (size_t i = 0; i < N; ++i) c += m_weights[i] * x[i];
+        return c;
+    }
+
+    //! @brief Learns the time in seconds taken by a run with given features.
+    void learn(features_type const& x, double t) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (size_t i = 0; i < N; ++i) {
+            for (size_t j = 0; j < N; ++j) m_a[i][j] += x[i] * x[j];
+            m_b[i] += x[i] * t;
+        }
+        ++m_samples;
+        fit();
+    }
+
+    //! @brief The current weights.
+    features_type weights() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_weights;
+    }
+
+    //! @brief The number of timings learned.
+    size_t samples() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_samples;
+    }
+
+  private:
+    //! @brief A feature vector with all equal values.
+    static features_type uniform(double v) {
+        features_type x;
+        x.fill(v);
+        return x;
+    }
+
+    /**
+     * @brief Refits the weights on the timings learned (with the mutex held).
+     *
+     * Solves the normal equations with a small ridge relative to the diagonal (so that fewer samples than features
+     * are handled), dropping features whose weight would be negative.
+     */
+    void fit() {
+        std::array<bool, N> active;
+        active.fill(true);
+        for (size_t iter = 0; iter < N; ++iter) {
+            std::array<std::array<double, N+1>, N> m;
+            for (size_t i = 0; i < N; ++i) {
+                for (size_t j = 0; j < N; ++j) m[i][j] = active[i] and active[j] ? m_a[i][j] : 0;
+                m[i][i] = active[i] ? m_a[i][i] * (1 + 1e-9) + 1e-300 : 1;
+                m[i][N] = active[i] ? m_b[i] : 0;
+            }
+            // gaussian elimination with partial pivoting
+            for (size_t c = 0; c < N; ++c) {
+                size_t p = c;
+                for (size_t r = c+1; r < N; ++r) if (std::abs(m[r][c]) > std::abs(m[p][c])) p = r;
+                std::swap(m[c], m[p]);
+                for (size_t r = 0; r < N; ++r) if (r != c and m[r][c] != 0) {
+                    double f = m[r][c] / m[c][c];
+                    for (size_t k = c; k <= N; ++k) m[r][k] -= f * m[c][k];
+                }
+            }
+            bool negative = false;
+            for (size_t i = 0; i < N; ++i) {
+                double w = m[i][N] / m[i][i];
+                if (active[i] and not (w >= 0)) active[i] = false, negative = true;
+            }
+            if (negative) continue;
+            for (size_t i = 0; i < N; ++i) m_weights[i] = active[i] ? m[i][N] / m[i][i] : 0;
+            return;
+        }
+    }
+
+    //! @brief The current weights.
+    features_type m_weights;
+    //! @brief The matrix of the normal equations.
+    std::array<features_type, N> m_a;
+    //! @brief The known terms of the normal equations.
+    features_type m_b;
+    //! @brief The number of timings learned.
+    size_t m_samples = 0;
+    //! @brief Mutex serialising access to the model.
+    mutable std::mutex m_mutex;
+};
+
+
+//! @brief Summary of a batch execution in longest-processing-time order.
+struct schedule_report {
+    //! @brief The number of runs performed.
+    size_t runs = 0;
+    //! @brief The wall-clock time of the whole execution (seconds).
+    double makespan = 0;
+    //! @brief The time between the first worker running out of work and the end of the execution (seconds).
+    double tail = 0;
+    //! @brief The longest run (seconds).
+    double longest = 0;
+
+    //! @brief Prints the report on a given stream.
+    friend std::ostream& operator<<(std::ostream& o, schedule_report const& r) {
+        o << r.runs << " runs in " << r.makespan << "s, tail " << r.tail << "s";
+        return o << " (" << 100 * r.tail / std::max(r.makespan, 1e-9) << "%), longest run " << r.longest << "s";
+    }
+};
+
+
+//! @cond INTERNAL
+namespace details {
+    //! @brief Seconds elapsed since a given time point.
+    inline double seconds_since(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    /**
+     * @brief Queue of the runs of a sequence in decreasing estimated cost (not thread-safe).
+     *
+     * The remaining runs are sorted again whenever the number of timings learned by the model doubles.
+     */
+    template <size_t N>
+    class lpt_queue {
+      public:
+        //! @brief Constructor given the features of the runs, and the model.
+        lpt_queue(std::vector<std::array<double, N>> features, cost_model<N>& model) : m_features(std::move(features)), m_model(model) {
+            for (size_t i = 0; i < m_features.size(); ++i) m_order.push_back(i);
+            std::reverse(m_order.begin(), m_order.end());
+            sort();
+        }
+
+        //! @brief Whether there are runs left.
+        bool empty() const {
+            return m_order.empty();
+        }
+
+        //! @brief The next run, removing it from the queue.
+        size_t pop() {
+            if (m_model.samples() >= 2 * m_sorted) sort();
+            size_t i = m_order.back();
+            m_order.pop_back();
+            return i;
+        }
+
+        //! @brief Learns the time in seconds taken by a run.
+        void learn(size_t i, double t) {
+            m_model.learn(m_features[i], t);
+        }
+
+      private:
+        //! @brief Sorts the remaining runs (the costliest last, ties in sequence order).
+        void sort() {
+            m_sorted = std::max<size_t>(m_model.samples(), 1);
+            std::vector<double> cost(m_features.size());
+            for (size_t i : m_order) cost[i] = m_model.estimate(m_features[i]);
+            std::stable_sort(m_order.begin(), m_order.end(), [&](size_t i, size_t j){
+                return cost[i] < cost[j];
+            });
+        }
+
+        //! @brief The features of the runs.
+        std::vector<std::array<double, N>> m_features;
+        //! @brief The cost model.
+        cost_model<N>& m_model;
+        //! @brief The remaining runs.
+        std::vector<size_t> m_order;
+        //! @brief The number of timings learned at the last sort.
+        size_t m_sorted = 0;
+    };
+
+    //! @brief The features of all runs in a sequence.
+    template <size_t N, typename S, typename F>
+    std::vector<std::array<double, N>> features_of(S const& seq, F&& features) {
+        std::vector<std::array<double, N>> v;
+        v.reserve(seq.size());
+        for (size_t i = 0; i < seq.size(); ++i) v.push_back(features(seq[i]));
+        return v;
+    }
+
+    //! @brief Runs the simulation of a given initialisation tuple, returning the seconds taken.
+    template <typename T, typename U>
+    double timed_run(U const& t) {
+        auto start = std::chrono::steady_clock::now();
+        typename T::net network{t};
+        network.run();
+        return seconds_since(start);
+    }
+}
+//! @endcond
+
+
+/**
+ * @brief Runs a sequence of simulations in longest-processing-time order, learning the cost model from their timings.
+ *
+ * The estimated cost of a run is given by the model on the features computed by `features` from its initialisation
+ * tuple. Runs are distributed dynamically among a given number of threads, starting from the costliest, so that
+ * the threads finish at nearly the same time. Runs with equal estimated cost keep the order of the sequence (so a
+ * model with constant features gives plain dynamic scheduling).
+ */
+template <typename T, typename S, size_t N, typename F>
+schedule_report lpt_run(T, S const& seq, cost_model<N>& model, F&& features, size_t threads = std::thread::hardware_concurrency()) {
+    auto start = std::chrono::steady_clock::now();
+    details::lpt_queue<N> queue(details::features_of<N>(seq, features), model);
+    std::mutex m;
+    schedule_report report;
+    bool idle = false;
+    auto worker = [&](){
+        std::unique_lock<std::mutex> lock(m);
+        while (not queue.empty()) {
+            size_t i = queue.pop();
+            lock.unlock();
+            double t = details::timed_run<T>(seq[i]);
+            lock.lock();
+            queue.learn(i, t);
+            ++report.runs;
+            report.longest = std::max(report.longest, t);
+        }
+        if (not idle) idle = true, report.tail = details::seconds_since(start);
+    };
+    std::vector<std::thread> pool;
+    for (size_t i = 1; i < threads; ++i) pool.emplace_back(worker);
+    worker();
+    for (std::thread& t : pool) t.join();
+    report.makespan = details::seconds_since(start);
+    report.tail = report.makespan - report.tail;
+    return report;
+}
+
+
+/**
+ * @brief Runs a sequence of simulations across MPI processes in longest-processing-time order.
+ *
+ * Every process should call this function with the same sequence, whose `plotter` tag should point to a
+ * process-local plotter. The master process (rank 0) dispatches runs one at a time to the threads of every
+ * process (whose number may differ between processes), starting from the costliest, and learns the cost model from the timings reported back. At the end,
+ * the plotters are merged into the plotter of the master process through a tree reduction. Without MPI, it reduces to `lpt_run`.
+ */
+template <typename T, typename S, size_t N, typename F>
+schedule_report distributed_lpt_run(T x, S const& seq, cost_model<N>& model, F&& features, size_t threads = std::thread::hardware_concurrency()) {
+#ifdef FCPP_MPI
+    (void)x;
+    constexpr int request_tag = 1429;
+    constexpr int reply_tag = 1430;
+    int rank, n_procs;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &n_procs);
+    // waits for the master to leave any previous execution, which would otherwise serve the requests of this one
+    MPI_Barrier(MPI_COMM_WORLD);
+    // the master learns the number of threads of every process, each asking for runs until it gets none
+    unsigned long long own = threads;
+    std::vector<unsigned long long> counts(rank == 0 ? n_procs : 0);
+    MPI_Gather(&own, 1, MPI_UNSIGNED_LONG_LONG, counts.data(), 1, MPI_UNSIGNED_LONG_LONG, 0, MPI_COMM_WORLD);
+    auto start = std::chrono::steady_clock::now();
+    schedule_report report;
+    std::mutex m;
+    if (rank == 0) {
+        details::lpt_queue<N> queue(details::features_of<N>(seq, features), model);
+        bool idle = false;
+        // gets the next run (with the lock held)
+        auto next = [&]() -> long long {
+            if (not queue.empty()) return queue.pop();
+            if (not idle) idle = true, report.tail = details::seconds_since(start);
+            return -1;
+        };
+        // records a completed run (with the lock held)
+        auto complete = [&](size_t i, double t) {
+            queue.learn(i, t);
+            ++report.runs;
+            report.longest = std::max(report.longest, t);
+        };
+        auto worker = [&](){
+            std::unique_lock<std::mutex> lock(m);
+            for (long long i = next(); i >= 0; i = next()) {
+                lock.unlock();
+                double t = details::timed_run<T>(seq[i]);
+                lock.lock();
+                complete(i, t);
+            }
+        };
+        std::vector<std::thread> pool;
+        for (size_t i = 0; i < threads; ++i) pool.emplace_back(worker);
+        // serves the requests of the other processes: every thread asks for a run until it gets none
+        size_t finished = 0, slots = 0;
+        for (int p = 1; p < n_procs; ++p) slots += counts[p];
+        while (finished < slots) {
+            int flag;
+            MPI_Status status;
+            MPI_Iprobe(MPI_ANY_SOURCE, request_tag, MPI_COMM_WORLD, &flag, &status);
+            if (not flag) {
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+                continue;
+            }
+            double done[2];
+            MPI_Recv(done, 2, MPI_DOUBLE, status.MPI_SOURCE, request_tag, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+            long long i;
+            {
+                std::lock_guard<std::mutex> lock(m);
+                if (done[0] >= 0) complete(size_t(done[0]), done[1]);
+                i = next();
+            }
+            MPI_Send(&i, 1, MPI_LONG_LONG, status.MPI_SOURCE, reply_tag, MPI_COMM_WORLD);
+            if (i < 0) ++finished;
+        }
+        for (std::thread& t : pool) t.join();
+    } else {
+        // threads wait for a run to be assigned to their slot, and leave the timing for the main thread to report
+        constexpr long long unset = -2;
+        std::vector<long long> job(threads, unset);
+        std::vector<std::pair<size_t, double>> done;
+        std::condition_variable cv;
+        auto worker = [&](size_t w){
+            std::unique_lock<std::mutex> lock(m);
+            while (true) {
+                cv.wait(lock, [&](){
+                    return job[w] != unset;
+                });
+                if (job[w] < 0) return;
+                size_t i = job[w];
+                lock.unlock();
+                double t = details::timed_run<T>(seq[i]);
+                lock.lock();
+                job[w] = unset;
+                done.emplace_back(w, t);
+                report.longest = std::max(report.longest, t);
+                ++report.runs;
+                cv.notify_all();
+            }
+        };
+        // asks the master for the next run of a slot, reporting the last one (from the main thread only)
+        std::vector<long long> last(threads, -1);
+        size_t finished = 0;
+        auto request = [&](size_t w, double t) {
+            double d[2] = {double(last[w]), t};
+            long long i;
+            // the lock is not held during the round-trip to the master, so that other threads can complete runs
+            MPI_Send(d, 2, MPI_DOUBLE, 0, request_tag, MPI_COMM_WORLD);
+            MPI_Recv(&i, 1, MPI_LONG_LONG, 0, reply_tag, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+            last[w] = i;
+            std::lock_guard<std::mutex> lock(m);
+            job[w] = i;
+            finished += i < 0;
+            cv.notify_all();
+        };
+        std::vector<std::thread> pool;
+        for (size_t w = 0; w < threads; ++w) pool.emplace_back(worker, w);
+        for (size_t w = 0; w < threads; ++w) request(w, 0);
+        while (true) {
+            std::pair<size_t, double> d;
+            {
+                std::unique_lock<std::mutex> lock(m);
+                if (finished == threads) break;
+                cv.wait(lock, [&](){
+                    return not done.empty();
+                });
+                d = done.back();
+                done.pop_back();
+            }
+            request(d.first, d.second);
+        }
+        for (std::thread& t : pool) t.join();
+    }
+    // merges the plotters into the master one
+    if (seq.size() > 0) tree_reduce(*common::get<component::tags::plotter>(seq[0]));
+    report.makespan = details::seconds_since(start);
+    if (rank == 0) report.tail = report.makespan - report.tail;
+    return report;
+#else
+    return lpt_run(x, seq, model, features, threads);
+#endif
+}
+
+
+} // namespace batch
+
+
+} // namespace fcpp
+
+#endif // FCPP_COST_SCHEDULE_H_
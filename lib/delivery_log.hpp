@@ -0,0 +1,116 @@
+// Copyright © 2026 Giorgio Audrito. All Rights Reserved.
+
+/**
+ * @file delivery_log.hpp
+ * @brief Bounded log of delivered items, retained for a given time window.
+ */
+
+#ifndef FCPP_DELIVERY_LOG_H_
+#define FCPP_DELIVERY_LOG_H_
+
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <vector>
+
+#include "lib/settings.hpp"
+#include "lib/flat_hash.hpp"
+
+
+/**
+ * @brief Namespace containing all the objects in the FCPP library.
+ */
+namespace fcpp {
+
+
+/**
+ * @brief Log of delivered items, bucketed by their creation time in a ring of `B` buckets.
+ *
+ * Items are expected to have a `time` member, holding their creation time. Items created more than
+ * a window of time before the latest evicted time are dropped a whole bucket at a time, so that the
+ * log size is bounded by the items created in the window. Items older than the window are
+ * considered as already delivered, and are reported as expired so that they can be told apart from
+ * repeated deliveries. Meant to be updated in place (e.g. from the node storage).
+ *
+ * @param K The type of the items.
+ * @param H The hasher for the items.
+ * @param B The number of buckets.
+ */
+template <typename K, typename H = std::hash<K>, size_t B = 16>
+class delivery_log {
+    static_assert(B > 1, "at least two buckets are needed");
+
+  public:
+    //! @brief Constructor given the retention window.
+    delivery_log(times_t window = 100) : m_width(window / (B-1)), m_buckets(B) {}
+
+    //! @brief The retention window.
+    times_t window() const {
+        return m_width * (B-1);
+    }
+
+    //! @brief The number of items currently retained.
+    size_t size() const {
+        size_t s = 0;
+        for (auto const& b : m_buckets) s += b.size();
+        return s;
+    }
+
+    //! @brief Drops the items created more than a window before a given time.
+    void evict(times_t t) {
+        advance(index(t) - int64_t(B-1));
+    }
+
+    //! @brief Whether an item is older than the window (so that its deliveries are not recorded).
+    bool expired(K const& k) const {
+        return index(k.time) < m_start;
+    }
+
+    //! @brief Records the delivery of an item, returning whether it is the first one (false for expired items).
+    bool insert(K const& k) {
+        int64_t i = index(k.time);
+        if (i < m_start) return false;
+        advance(i - int64_t(B-1));
+        return m_buckets[i % B].insert(k).second;
+    }
+
+    //! @brief Whether an item has been delivered (items older than the window are assumed delivered).
+    bool count(K const& k) const {
+        int64_t i = index(k.time);
+        if (i < m_start) return true;
+        if (i >= m_start + int64_t(B)) return false;
+        return m_buckets[i % B].count(k) > 0;
+    }
+
+    //! @brief Prints a summary of the log on a given stream.
+    friend std::ostream& operator<<(std::ostream& o, delivery_log const& l) {
+        return o << "log(" << l.size() << ")";
+    }
+
+  private:
+    //! @brief The bucket index for a given time.
+    int64_t index(times_t t) const {
+        return m_width > 0 ? int64_t(std::floor(t / m_width)) : 0;
+    }
+
+    //! @brief Clears buckets until a given index is the first in the ring.
+    void advance(int64_t start) {
+        if (start <= m_start) return;
+        for (int64_t i = m_start; i < start and i < m_start + int64_t(B); ++i)
+            m_buckets[i % B].clear();
+        m_start = start;
+    }
+
+    //! @brief The time span of every bucket.
+    times_t m_width;
+    //! @brief The index of the first bucket in the ring.
+    int64_t m_start = 0;
+    //! @brief The buckets of items.
+    std::vector<flat_set<K, H>> m_buckets;
+};
+
+
+} // namespace fcpp
+
+#endif // FCPP_DELIVERY_LOG_H_
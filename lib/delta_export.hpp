@@ -0,0 +1,291 @@
+// Copyright © 2026 Giorgio Audrito. All Rights Reserved.
+
+/**
+ * @file delta_export.hpp
+ * @brief Sharing of set and map values with neighbours through delta-encoded exports.
+ *
+ * Values are exchanged as the chain of insertions and deletions since the oldest version still
+ * held by some neighbour (as acknowledged in its own exports), falling back to a full snapshot
+ * when a neighbour holds no usable version. Local copies of the values of neighbours are kept
+ * through `old`, so `export_split<true>` is needed for them not to be sent to neighbours.
+ */
+
+#ifndef FCPP_DELTA_EXPORT_H_
+#define FCPP_DELTA_EXPORT_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include "lib/beautify.hpp"
+#include "lib/coordination.hpp"
+#include "lib/flat_hash.hpp"
+
+
+/**
+ * @brief Namespace containing all the objects in the FCPP library.
+ */
+namespace fcpp {
+
+
+//! @brief Marks a set or map container to be shared through delta-encoded exports.
+template <typename C>
+class delta_encoded : public C {
+  public:
+    //! @brief Inherited constructors.
+    using C::C;
+
+    //! @brief Default constructor.
+    delta_encoded() = default;
+
+    //! @brief Conversion from the container.
+    delta_encoded(C const& c) : C(c) {}
+};
+
+//! @brief Whether a type is marked to be shared through delta-encoded exports.
+template <typename T>
+struct is_delta_encoded : std::false_type {};
+
+//! @brief Whether a type is marked to be shared through delta-encoded exports (true overload).
+template <typename C>
+struct is_delta_encoded<delta_encoded<C>> : std::true_type {};
+
+
+//! @cond INTERNAL
+namespace details {
+    //! @brief The key of a set element.
+    template <typename T>
+    T const& delta_key(T const& x) {
+        return x;
+    }
+
+    //! @brief The key of a map element.
+    template <typename K, typename V>
+    K const& delta_key(std::pair<K, V> const& x) {
+        return x.first;
+    }
+}
+//! @endcond
+
+
+//! @brief Insertions and deletions turning a version of a container into the next one.
+template <typename C>
+struct delta_step {
+    //! @brief Elements inserted (or whose value changed).
+    std::vector<typename C::value_type> ins;
+    //! @brief Keys deleted (or whose value changed).
+    std::vector<typename C::key_type> del;
+
+    //! @brief Empty constructor.
+    delta_step() = default;
+
+    //! @brief Difference between two versions of a container.
+    delta_step(C const& before, C const& after) {
+        for (auto const& x : before) {
+            auto it = after.find(details::delta_key(x));
+            if (it == after.end() or not (*it == x)) del.push_back(details::delta_key(x));
+        }
+        for (auto const& x : after) {
+            auto it = before.find(details::delta_key(x));
+            if (it == before.end() or not (*it == x)) ins.push_back(x);
+        }
+    }
+
+    //! @brief The number of elements and keys in the step.
+    size_t size() const {
+        return ins.size() + del.size();
+    }
+
+    //! @brief Applies the step to a container.
+    void apply(C& c) const {
+        for (auto const& k : del) c.erase(k);
+        for (auto const& x : ins) c.insert(x);
+    }
+
+    //! @brief Serialises the content from/to a given input/output stream.
+    template <typename S>
+    S& serialize(S& s) {
+        return s & ins & del;
+    }
+
+    //! @brief Serialises the content from/to a given input/output stream (const overload).
+    template <typename S>
+    S& serialize(S& s) const {
+        return s << ins << del;
+    }
+};
+
+
+//! @brief Value shared with neighbours: a chain of steps (or a full snapshot) and acknowledgements.
+template <typename C>
+struct delta_payload {
+    //! @brief The version reached by the steps (zero for no value).
+    uint32_t version = 0;
+    //! @brief Whether the only step is a full snapshot.
+    bool full = false;
+    //! @brief The steps leading to the version.
+    std::vector<delta_step<C>> steps;
+    //! @brief Neighbours whose values are held.
+    std::vector<device_t> ack_ids;
+    //! @brief Versions of neighbours' values held.
+    std::vector<uint32_t> ack_versions;
+
+    //! @brief Serialises the content from/to a given input/output stream.
+    template <typename S>
+    S& serialize(S& s) {
+        return s & version & full & steps & ack_ids & ack_versions;
+    }
+
+    //! @brief Serialises the content from/to a given input/output stream (const overload).
+    template <typename S>
+    S& serialize(S& s) const {
+        return s << version << full << steps << ack_ids << ack_versions;
+    }
+};
+
+
+//! @brief Local state of a delta-encoded sharing: own history and copies of neighbours' values.
+template <typename C, size_t H>
+struct delta_state {
+    //! @brief The current version of the own value.
+    uint32_t version = 0;
+    //! @brief The own value.
+    C value;
+    //! @brief The last (at most H) steps leading to the current version.
+    std::vector<delta_step<C>> steps;
+    //! @brief Neighbours whose values are held (sorted).
+    std::vector<device_t> ids;
+    //! @brief Versions of neighbours' values held.
+    std::vector<uint32_t> versions;
+    //! @brief Neighbours' values held.
+    std::vector<C> values;
+
+    //! @brief Serialises the content from/to a given input/output stream.
+    template <typename S>
+    S& serialize(S& s) {
+        return s & version & value & steps & ids & versions & values;
+    }
+
+    //! @brief Serialises the content from/to a given input/output stream (const overload).
+    template <typename S>
+    S& serialize(S& s) const {
+        return s << version << value << steps << ids << versions << values;
+    }
+};
+
+
+//! @brief Namespace containing the libraries of coordination routines.
+namespace coordination {
+
+
+/**
+ * @brief Shares a set or map value with neighbours (as `nbr(CALL, init, f)`) through delta-encoded exports.
+ *
+ * The function `f` receives the field of values of neighbours (`init` for neighbours whose value could not be
+ * reconstructed yet), and its result is shared with neighbours and returned. Up to `H` steps are kept for
+ * neighbours lagging behind.
+ */
+template <size_t H = 4, typename node_t, typename C, typename F>
+C delta_nbr(ARGS, C const& init, F&& f) { CODE
+    using state_t = delta_state<C, H>;
+    using payload_t = delta_payload<C>;
+    C result;
+    old(CALL, state_t{}, [&](state_t s){
+        nbr(CALL, payload_t{}, [&](field<payload_t> const& p){
+            state_t t;
+            // oldest version of the own value held by a neighbour (0 if some neighbour holds none)
+            uint32_t oldest = s.version;
+            // updates the copies of neighbours' values
+            map_hood([&](payload_t const& x, device_t id){
+                if (x.version == 0 or id == node.uid) return 0;
+                auto it = std::lower_bound(s.ids.begin(), s.ids.end(), id);
+                size_t i = it - s.ids.begin();
+                bool held = it != s.ids.end() and *it == id;
+                uint32_t v = held ? s.versions[i] : 0;
+                C c = held ? s.values[i] : C{};
+                size_t first = x.version - x.steps.size();
+                if (x.full) {
+                    c = C{};
+                    x.steps.front().apply(c);
+                    v = x.version;
+                } else if (held and v >= first and v < x.version) {
+                    for (size_t j = v - first; j < x.steps.size(); ++j) x.steps[j].apply(c);
+                    v = x.version;
+                } else if (v != x.version) v = 0;
+                if (v > 0) {
+                    t.ids.push_back(id);
+                    t.versions.push_back(v);
+                    t.values.push_back(std::move(c));
+                }
+                auto jt = std::find(x.ack_ids.begin(), x.ack_ids.end(), node.uid);
+                oldest = std::min(oldest, jt == x.ack_ids.end() ? 0 : x.ack_versions[jt - x.ack_ids.begin()]);
+                return 0;
+            }, p, node.nbr_uid());
+            std::vector<size_t> order(t.ids.size());
+            for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+            std::sort(order.begin(), order.end(), [&](size_t i, size_t j){
+                return t.ids[i] < t.ids[j];
+            });
+            s.ids.clear();
+            s.versions.clear();
+            s.values.clear();
+            for (size_t i : order) {
+                s.ids.push_back(t.ids[i]);
+                s.versions.push_back(t.versions[i]);
+                s.values.push_back(std::move(t.values[i]));
+            }
+            // computes the new value from the field of neighbours' values
+            result = f(map_hood([&](device_t id){
+                if (id == node.uid) return s.version > 0 ? s.value : init;
+                auto it = std::lower_bound(s.ids.begin(), s.ids.end(), id);
+                return it != s.ids.end() and *it == id ? s.values[it - s.ids.begin()] : init;
+            }, node.nbr_uid()));
+            // updates the own history
+            s.steps.emplace_back(s.value, result);
+            if (s.steps.size() > H) s.steps.erase(s.steps.begin());
+            s.value = result;
+            ++s.version;
+            // builds the payload, as the steps since the oldest version held or a full snapshot
+            payload_t q;
+            q.version = s.version;
+            q.ack_ids = s.ids;
+            q.ack_versions = s.versions;
+            size_t first = s.version - s.steps.size();
+            size_t chain = 0;
+            if (oldest >= first) for (size_t j = oldest - first; j < s.steps.size(); ++j) chain += s.steps[j].size();
+            if (oldest < first or chain >= s.value.size()) {
+                q.full = true;
+                q.steps.emplace_back(C{}, s.value);
+            } else q.steps.assign(s.steps.begin() + (oldest - first), s.steps.end());
+            return q;
+        });
+        return s;
+    });
+    return result;
+}
+//! @brief Export list for delta_nbr.
+template <typename C, size_t H = 4>
+using delta_nbr_t = common::export_list<delta_state<C, H>, delta_payload<C>>;
+
+
+//! @brief Collection along a spanning tree towards a source (as `sp_collection`), sharing values through delta-encoded exports.
+template <typename node_t, typename C, typename G>
+C delta_collection(ARGS, double distance, C const& value, C const& null, G&& accumulate) { CODE
+    device_t parent = get<1>(min_hood(CALL, make_tuple(nbr(CALL, distance), node.nbr_uid())));
+    field<bool> child = nbr(CALL, parent) == node.uid;
+    return delta_nbr(CALL, null, [&](field<C> const& x){
+        return fold_hood(CALL, accumulate, mux(child, x, null), value);
+    });
+}
+//! @brief Export list for delta_collection.
+template <typename C>
+using delta_collection_t = common::export_list<double, device_t, delta_nbr_t<C>>;
+
+
+} // namespace coordination
+
+
+} // namespace fcpp
+
+#endif // FCPP_DELTA_EXPORT_H_
@@ -0,0 +1,424 @@
+// Copyright © 2026 Giorgio Audrito. All Rights Reserved.
+
+/**
+ * @file flat_hash.hpp
+ * @brief Hash sets and maps with open addressing on contiguous storage, and hash mixing functions.
+ */
+
+#ifndef FCPP_FLAT_HASH_H_
+#define FCPP_FLAT_HASH_H_
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+/**
+ * @brief Namespace containing all the objects in the FCPP library.
+ */
+namespace fcpp {
+
+
+//! @brief Mixes the bits of a 64-bit value (splitmix64 finaliser, a bijection).
+inline uint64_t hash_mix(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+//! @brief Combines a hash with an additional 64-bit value.
+inline uint64_t hash_combine(uint64_t h, uint64_t x) {
+    return hash_mix(h ^ (x + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2)));
+}
+
+//! @brief The bits of a floating-point value, suitable for hashing (equal values have equal bits).
+template <typename T>
+uint64_t hash_bits(T x) {
+    static_assert(sizeof(T) <= sizeof(uint64_t), "type too large for hashing");
+    uint64_t b = 0;
+    if (x != 0) std::memcpy(&b, &x, sizeof(T)); // 0 and -0 compare equal
+    return b;
+}
+
+
+//! @cond INTERNAL
+namespace details {
+    //! @brief Extracts the key from a set element.
+    struct set_key {
+        template <typename T>
+        T const& operator()(T const& x) const {
+            return x;
+        }
+    };
+
+    //! @brief Extracts the key from a map element.
+    struct map_key {
+        template <typename K, typename V>
+        K const& operator()(std::pair<K, V> const& x) const {
+            return x.first;
+        }
+    };
+
+    /**
+     * @brief Open addressing hash table with linear probing and backward-shift deletion.
+     *
+     * Elements are stored contiguously, together with a parallel vector of occupancy flags.
+     * The capacity is always a power of two, and the table is kept at most 3/4 full.
+     *
+     * @param T The type of the elements.
+     * @param K The type of the keys.
+     * @param G Extractor of a key from an element.
+     * @param H The hasher for the keys.
+     * @param E The equality predicate for the keys.
+     */
+    template <typename T, typename K, typename G, typename H, typename E>
+    class flat_table {
+      public:
+        //! @brief Iterator on the table, possibly constant.
+        template <bool is_const>
+        class basic_iterator {
+            //! @brief The type of the table pointed to.
+            using table_t = std::conditional_t<is_const, flat_table const, flat_table>;
+
+          public:
+            //! @brief Iterator traits.
+            //! @{
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+            using pointer = std::conditional_t<is_const, T const*, T*>;
+            using reference = std::conditional_t<is_const, T const&, T&>;
+            //! @}
+
+            //! @brief Default constructor.
+            basic_iterator() = default;
+
+            //! @brief Constructor given a table and a slot (moved to the next occupied slot).
+            basic_iterator(table_t* t, size_t i) : m_table(t), m_index(i) {
+                skip();
+            }
+
+            //! @brief Conversion to a constant iterator.
+            operator basic_iterator<true>() const {
+                return {m_table, m_index};
+            }
+
+            //! @brief Dereferencing.
+            reference operator*() const {
+                return m_table->m_slots[m_index];
+            }
+
+            //! @brief Member access.
+            pointer operator->() const {
+                return &m_table->m_slots[m_index];
+            }
+
+            //! @brief Pre-increment.
+            basic_iterator& operator++() {
+                ++m_index;
+                skip();
+                return *this;
+            }
+
+            //! @brief Post-increment.
+            basic_iterator operator++(int) {
+                basic_iterator i = *this;
+                ++*this;
+                return i;
+            }
+
+            //! @brief Equality operator.
+            bool operator==(basic_iterator const& o) const {
+                return m_index == o.m_index;
+            }
+
+            //! @brief Inequality operator.
+            bool operator!=(basic_iterator const& o) const {
+                return m_index != o.m_index;
+            }
+
+          private:
+            friend class flat_table;
+
+            //! @brief Moves to the first occupied slot from the current one.
+            void skip() {
+                while (m_index < m_table->m_used.size() and not m_table->m_used[m_index]) ++m_index;
+            }
+
+            //! @brief The table.
+            table_t* m_table = nullptr;
+            //! @brief The current slot.
+            size_t m_index = 0;
+        };
+
+        //! @brief Container traits.
+        //! @{
+        using key_type = K;
+        using value_type = T;
+        using size_type = size_t;
+        using hasher = H;
+        using key_equal = E;
+        using iterator = basic_iterator<false>;
+        using const_iterator = basic_iterator<true>;
+        //! @}
+
+        //! @brief Empty table.
+        flat_table() = default;
+
+        //! @brief Table from a list of elements.
+        flat_table(std::initializer_list<T> l) {
+            reserve(l.size());
+            for (T const& x : l) insert(x);
+        }
+
+        //! @brief Iterator to the first element.
+        iterator begin() {
+            return {this, 0};
+        }
+
+        //! @brief Constant iterator to the first element.
+        const_iterator begin() const {
+            return {this, 0};
+        }
+
+        //! @brief Iterator past the last element.
+        iterator end() {
+            return {this, m_used.size()};
+        }
+
+        //! @brief Constant iterator past the last element.
+        const_iterator end() const {
+            return {this, m_used.size()};
+        }
+
+        //! @brief The number of elements.
+        size_t size() const {
+            return m_size;
+        }
+
+        //! @brief Whether the table is empty.
+        bool empty() const {
+            return m_size == 0;
+        }
+
+        //! @brief Removes every element, keeping the allocated storage.
+        void clear() {
+            for (size_t i = 0; i < m_used.size(); ++i) if (m_used[i]) {
+                m_slots[i] = T{};
+                m_used[i] = false;
+            }
+            m_size = 0;
+        }
+
+        //! @brief Makes room for a given number of elements without further allocations.
+        void reserve(size_t n) {
+            if (4*n <= 3*m_used.size()) return;
+            size_t c = 8;
+            while (4*n > 3*c) c *= 2;
+            rehash(c);
+        }
+
+        //! @brief Iterator to the element with a given key (or end).
+        iterator find(K const& k) {
+            return {this, lookup(k)};
+        }
+
+        //! @brief Constant iterator to the element with a given key (or end).
+        const_iterator find(K const& k) const {
+            return {this, lookup(k)};
+        }
+
+        //! @brief The number of elements with a given key (0 or 1).
+        size_t count(K const& k) const {
+            return lookup(k) < m_used.size();
+        }
+
+        //! @brief Inserts an element, if its key is not already present.
+        std::pair<iterator, bool> insert(T x) {
+            reserve(m_size + 1);
+            size_t i = probe(G{}(x));
+            if (m_used[i]) return {iterator{this, i}, false};
+            m_slots[i] = std::move(x);
+            m_used[i] = true;
+            ++m_size;
+            return {iterator{this, i}, true};
+        }
+
+        //! @brief Inserts a range of elements.
+        template <typename I>
+        void insert(I first, I last) {
+            for (; first != last; ++first) insert(*first);
+        }
+
+        //! @brief Removes the element with a given key, returning the number of elements removed.
+        size_t erase(K const& k) {
+            size_t i = lookup(k);
+            if (i == m_used.size()) return 0;
+            size_t mask = m_used.size() - 1;
+            for (size_t j = (i+1) & mask; m_used[j]; j = (j+1) & mask) {
+                // moves back elements whose home slot is not cyclically in (i,j]
+                size_t h = home(G{}(m_slots[j]));
+                if (((j - h) & mask) >= ((j - i) & mask)) {
+                    m_slots[i] = std::move(m_slots[j]);
+                    i = j;
+                }
+            }
+            m_slots[i] = T{};
+            m_used[i] = false;
+            --m_size;
+            return 1;
+        }
+
+        //! @brief Equality operator.
+        bool operator==(flat_table const& o) const {
+            if (m_size != o.m_size) return false;
+            for (T const& x : *this) {
+                size_t i = o.lookup(G{}(x));
+                if (i == o.m_used.size() or not (o.m_slots[i] == x)) return false;
+            }
+            return true;
+        }
+
+        //! @brief Inequality operator.
+        bool operator!=(flat_table const& o) const {
+            return not (*this == o);
+        }
+
+        //! @brief Serialises the content from/to a given input/output stream.
+        template <typename S>
+        S& serialize(S& s) {
+            size_t n = m_size;
+            s & n;
+            clear();
+            reserve(n);
+            for (size_t i = 0; i < n; ++i) {
+                T x;
+                s & x;
+                insert(std::move(x));
+            }
+            return s;
+        }
+
+        //! @brief Serialises the content from/to a given input/output stream (const overload).
+        template <typename S>
+        S& serialize(S& s) const {
+            s << m_size;
+            for (T const& x : *this) s << x;
+            return s;
+        }
+
+      protected:
+        //! @brief The slot of the element with a given key, inserting it if missing.
+        T& access(K const& k) {
+            reserve(m_size + 1);
+            size_t i = probe(k);
+            if (not m_used[i]) {
+                G{}.assign(m_slots[i], k);
+                m_used[i] = true;
+                ++m_size;
+            }
+            return m_slots[i];
+        }
+
+      private:
+        //! @brief The home slot of a key.
+        size_t home(K const& k) const {
+            return hash_mix(H{}(k)) & (m_used.size() - 1);
+        }
+
+        //! @brief The slot holding a key, or the empty slot where it would be inserted (non-empty table).
+        size_t probe(K const& k) const {
+            size_t mask = m_used.size() - 1;
+            size_t i = home(k);
+            while (m_used[i] and not E{}(G{}(m_slots[i]), k)) i = (i+1) & mask;
+            return i;
+        }
+
+        //! @brief The slot holding a key, or the capacity if missing.
+        size_t lookup(K const& k) const {
+            if (m_size == 0) return m_used.size();
+            size_t i = probe(k);
+            return m_used[i] ? i : m_used.size();
+        }
+
+        //! @brief Moves the elements into a table with a given capacity.
+        void rehash(size_t c) {
+            std::vector<T> slots(c);
+            std::vector<uint8_t> used(c, false);
+            std::swap(slots, m_slots);
+            std::swap(used, m_used);
+            for (size_t i = 0; i < used.size(); ++i) if (used[i]) {
+                size_t j = probe(G{}(slots[i]));
+                m_slots[j] = std::move(slots[i]);
+                m_used[j] = true;
+            }
+        }
+
+        //! @brief The slots of the table.
+        std::vector<T> m_slots;
+        //! @brief Whether slots are occupied.
+        std::vector<uint8_t> m_used;
+        //! @brief The number of elements.
+        size_t m_size = 0;
+    };
+
+    //! @brief Extracts and assigns the key of a map element.
+    struct map_key_assign : map_key {
+        template <typename K, typename V>
+        void assign(std::pair<K, V>& x, K const& k) const {
+            x.first = k;
+        }
+    };
+}
+//! @endcond
+
+
+/**
+ * @brief Hash set with open addressing on contiguous storage.
+ *
+ * Mostly a drop-in replacement for `std::unordered_set`, allocating only when growing.
+ * Iterators and references are invalidated by insertions and removals.
+ */
+template <typename K, typename H = std::hash<K>, typename E = std::equal_to<K>>
+using flat_set = details::flat_table<K, K, details::set_key, H, E>;
+
+
+/**
+ * @brief Hash map with open addressing on contiguous storage.
+ *
+ * Mostly a drop-in replacement for `std::unordered_map`, allocating only when growing.
+ * Iterators and references are invalidated by insertions and removals.
+ */
+template <typename K, typename V, typename H = std::hash<K>, typename E = std::equal_to<K>>
+class flat_map : public details::flat_table<std::pair<K, V>, K, details::map_key_assign, H, E> {
+    //! @brief The parent type.
+    using parent_t = details::flat_table<std::pair<K, V>, K, details::map_key_assign, H, E>;
+
+  public:
+    //! @brief The type of mapped values.
+    using mapped_type = V;
+
+    //! @brief Inherited constructors.
+    using parent_t::parent_t;
+
+    //! @brief Default constructor.
+    flat_map() = default;
+
+    //! @brief Access to the value for a given key, inserting a default value if missing.
+    V& operator[](K const& k) {
+        return this->access(k).second;
+    }
+};
+
+
+} // namespace fcpp
+
+#endif // FCPP_FLAT_HASH_H_
@@ -8,9 +8,12 @@
 #ifndef FCPP_MESSAGE_DISPATCH_H_
 #define FCPP_MESSAGE_DISPATCH_H_
 
-#include "lib/beautify.hpp"
-#include "lib/coordination.hpp"
-#include "lib/data.hpp"
+#include "lib/fcpp.hpp"
+#include "lib/delivery_log.hpp"
+#include "lib/delta_export.hpp"
+#include "lib/flat_hash.hpp"
+#include "lib/routing_summary.hpp"
+#include "lib/tree_oracle.hpp"
 
 
 //! @brief Struct representing a message.
@@ -33,10 +36,9 @@ struct message {
         return from == m.from and to == m.to and time == m.time;
     }
 
-    //! @brief Hash computation.
+    //! @brief Hash computation, mixing every bit of every field.
     size_t hash() const {
-        constexpr size_t offs = sizeof(size_t)*CHAR_BIT/3;
-        return (size_t(time) << (2*offs)) | (size_t(from) << (offs)) | size_t(to);
+        return fcpp::hash_combine(fcpp::hash_combine(fcpp::hash_mix(from), to), fcpp::hash_bits(time));
     }
 
     //! @brief Serialises the content from/to a given input/output stream.
@@ -53,15 +55,61 @@ struct message {
 };
 
 
+//! @brief Struct identifying a batch of messages, with a common receiver and creation time window.
+struct batch_key {
+    //! @brief Receiver UID.
+    fcpp::device_t to;
+    //! @brief Index of the creation time window.
+    int window;
+
+    //! @brief Empty constructor.
+    batch_key() = default;
+
+    //! @brief Member constructor.
+    batch_key(fcpp::device_t to, int window) : to(to), window(window) {}
+
+    //! @brief Equality operator.
+    bool operator==(batch_key const& k) const {
+        return to == k.to and window == k.window;
+    }
+
+    //! @brief Hash computation, mixing every bit of every field.
+    size_t hash() const {
+        return fcpp::hash_combine(fcpp::hash_mix(to), window);
+    }
+
+    //! @brief Serialises the content from/to a given input/output stream.
+    template <typename S>
+    S& serialize(S& s) {
+        return s & to & window;
+    }
+
+    //! @brief Serialises the content from/to a given input/output stream (const overload).
+    template <typename S>
+    S& serialize(S& s) const {
+        return s << to << window;
+    }
+};
+
+
 namespace std {
     //! @brief Hasher object for the message struct.
     template <>
     struct hash<message> {
-        //! @brief Produces an hash for a message, combining to and from into a size_t.
+        //! @brief Produces an hash for a message, combining every field into a size_t.
         size_t operator()(message const& m) const {
             return m.hash();
         }
     };
+
+    //! @brief Hasher object for the batch_key struct.
+    template <>
+    struct hash<batch_key> {
+        //! @brief Produces an hash for a batch key, combining every field into a size_t.
+        size_t operator()(batch_key const& k) const {
+            return k.hash();
+        }
+    };
 }
 
 
@@ -82,20 +130,20 @@ constexpr size_t discrete_sqrt(size_t n) {
     return lo;
 }
 
-//! @brief Number of devices.
-constexpr size_t devices = 300;
+//! @brief Default number of devices.
+constexpr size_t default_devices = 300;
 
 //! @brief Communication radius.
 constexpr size_t comm = 100;
 
-//! @brief Side of the deployment area.
-constexpr size_t side = discrete_sqrt(devices * 3000);
+//! @brief Default side of the deployment area.
+constexpr size_t default_side = discrete_sqrt(default_devices * 3000);
 
 //! @brief Height of the deployment area.
 constexpr size_t height = 100;
 
-//! @brief Color hue scale.
-constexpr float hue_scale = 360.0f/(side+height);
+//! @brief Length of the creation time windows of messages dispatched together in batches.
+constexpr times_t batch_window = 5;
 
 
 //! @brief Namespace containing the libraries of coordination routines.
@@ -106,6 +154,21 @@ namespace tags {
     //! @brief The movement speed of devices.
     struct speed {};
 
+    //! @brief The number of devices.
+    struct devices {};
+
+    //! @brief The side of deployment area.
+    struct side {};
+
+    //! @brief The density of devices (average number of neighbours).
+    struct dens {};
+
+    //! @brief The percentage probability of sending a message in a round.
+    struct rate {};
+
+    //! @brief The factor producing hues from distances.
+    struct hue_scale {};
+
     //! @brief The maximum message size ever exchanged by the node.
     struct max_msg {};
 
@@ -130,6 +193,9 @@ namespace tags {
     //! @brief Total number of repeated deliveries.
     struct repeat_count {};
 
+    //! @brief Total number of deliveries of messages older than the retention window of the delivery log.
+    struct expired_count {};
+
     //! @brief Distance to the central node.
     struct center_dist {};
 
@@ -147,17 +213,154 @@ namespace tags {
 
     //! @brief Shape of the current node.
     struct node_shape {};
+
+    //! @brief Oracle of the ancestors in the spanning tree.
+    struct tree {};
+
+    //! @brief Total number of process rounds run off the routing path.
+    struct false_route {};
+
+    //! @brief Identifier of the routing summary in use.
+    struct summary {};
+
+    //! @brief Log of the messages delivered to the current node.
+    struct delivered {};
+
+    //! @brief Whether messages are dispatched in batches.
+    struct multiplexed {};
 }
 
-//! @brief Shorthand for a set of devices.
-using set_t = std::unordered_set<device_t>;
-//! @brief Shorthand for a map associating times to messages.
+//! @brief Shorthand for a map associating times to messages (as returned by spawn).
 using map_t = std::unordered_map<message, times_t, common::hash<message>>;
+//! @brief Shorthand for a log of delivered messages.
+using log_t = delivery_log<message, common::hash<message>>;
+//! @brief Shorthand for a batch of messages.
+using batch_t = flat_set<message, common::hash<message>>;
+
+//! @brief Shorthand for a batch of messages, together with the messages of the batch known to be delivered.
+using batch_state_t = tuple<batch_t, batch_t>;
+
+//! @brief Whether a node is an ancestor of a device in the spanning tree, according to the shared oracle (for statistics only).
+template <typename node_t>
+bool tree_ancestor(node_t& node, device_t d) {
+    std::shared_ptr<tree_oracle> const& t = node.storage(tags::tree{});
+    return t and t->ancestor(node.uid, d);
+}
+
+//! @brief Collects routing summaries along the spanning tree.
+template <typename node_t, typename R>
+R summary_collection(ARGS, double ds, std::false_type) { CODE
+    return sp_collection(CALL, ds, R{node.uid}, R{}, routing::accumulate<R>);
+}
+
+//! @brief Collects routing summaries along the spanning tree, through delta-encoded exports.
+template <typename node_t, typename R>
+R summary_collection(ARGS, double ds, std::true_type) { CODE
+    return delta_collection(CALL, ds, R{node.uid}, R{}, routing::accumulate<R>);
+}
+
+//! @brief Exports for the summary_collection function.
+template <typename R>
+using summary_collection_t = std::conditional_t<is_delta_encoded<R>::value, delta_collection_t<R>, sp_collection_t<double, R>>;
+
+//! @brief Dispatches every message in its own aggregate process, returning the messages delivered.
+template <typename node_t, typename R>
+map_t dispatch(ARGS, R const& below, common::option<message> const& m, std::vector<color>& procs, std::false_type) { CODE
+    using namespace tags;
+    return spawn(CALL, [&](message const& m){
+        procs.push_back(color::hsva(m.to*360.0/node.storage(devices{}), 1, 1));
+        bool inpath = below.count(m.from) + below.count(m.to) > 0;
+        if (inpath and not tree_ancestor(node, m.from) and not tree_ancestor(node, m.to))
+            node.storage(false_route{}) += 1;
+        status s = node.uid == m.to ? status::terminated_output :
+                   inpath ? status::internal : status::border;
+        return make_tuple(node.current_time(), s);
+    }, m);
+}
 
-//! @brief Main function.
-MAIN() {
+/**
+ * @brief Dispatches messages in batches with a common receiver and creation time window, returning the messages delivered.
+ *
+ * Every batch runs in a single aggregate process, gathering the messages of the batch from the neighbourhood.
+ * The receiver outputs messages as they arrive, and acknowledges them back through the process. As with one
+ * process per message, no message is dropped before delivery: a device leaves the process only once every
+ * message it knows has been acknowledged, and no neighbour in the process is still waiting for acknowledgements.
+ * A message created later in the window (or in transit from afar) spawns the process again at its sender.
+ */
+template <typename node_t, typename R>
+map_t dispatch(ARGS, R const& below, common::option<message> const& m, std::vector<color>& procs, std::true_type) { CODE
+    using namespace tags;
+    common::option<batch_key> key;
+    for (message const& x : m) key.emplace(x.to, int(x.time / batch_window));
+    auto res = spawn(CALL, [&](batch_key const& k){
+        procs.push_back(color::hsva(k.to*360.0/node.storage(devices{}), 1, 1));
+        batch_t fresh;
+        for (message const& x : m) if (k == batch_key(x.to, int(x.time / batch_window))) fresh.insert(x);
+        bool inpath = below.count(k.to) > 0;
+        bool ancestor = tree_ancestor(node, k.to);
+        batch_t arrived;
+        bool waiting = false;
+        // pending messages of the batch and acknowledgements, known by neighbours or created here
+        nbr(CALL, batch_state_t{fresh, batch_t{}}, [&](field<batch_state_t> n){
+            batch_t msgs = fresh, acks;
+            map_hood([&](batch_state_t const& x, device_t id){
+                msgs.insert(get<0>(x).begin(), get<0>(x).end());
+                acks.insert(get<1>(x).begin(), get<1>(x).end());
+                // neighbours still waiting for acknowledgements keep the current device in the process
+                if (id != node.uid and not get<0>(x).empty()) waiting = true;
+                return 0;
+            }, n, node.nbr_uid());
+            batch_t pending;
+            for (message const& x : msgs) if (not acks.count(x)) {
+                if (node.uid == k.to) {
+                    arrived.insert(x);
+                    acks.insert(x);
+                } else pending.insert(x);
+            }
+            for (message const& x : pending) {
+                inpath = inpath or below.count(x.from) > 0;
+                ancestor = ancestor or tree_ancestor(node, x.from);
+            }
+            waiting = waiting or not pending.empty();
+            return make_tuple(pending, acks);
+        });
+        if (inpath and not ancestor) node.storage(false_route{}) += 1;
+        status s = node.uid == k.to ? (waiting ? status::internal_output : status::external_output) :
+                   inpath ? (waiting ? status::internal : status::external) :
+                   waiting ? status::border : status::external;
+        return make_tuple(arrived, s);
+    }, key);
+    map_t r;
+    for (auto const& x : res) for (message const& y : x.second) r[y] = node.current_time();
+    return r;
+}
+//! @brief Exports for the dispatch functions.
+FUN_EXPORT dispatch_t = export_list<spawn_t<message, status>, spawn_t<batch_key, status>, batch_state_t>;
+
+/**
+ * @brief Main function, parametrised by the routing summary type (see routing_summary.hpp).
+ *
+ * If `batched` is true, messages are dispatched in batches with a common receiver instead of one process each.
+ */
+template <typename R, bool batched = false>
+struct dispatch_main {
+    //! @brief Executes a round on a node.
+    template <typename node_t>
+    void operator()(node_t& node, times_t);
+};
+
+//! @brief Main function (with exact routing sets).
+using main = dispatch_main<routing::exact>;
+
+template <typename R, bool batched>
+template <typename node_t>
+void dispatch_main<R, batched>::operator()(node_t& node, times_t) {
     // import tags for convenience
     using namespace tags;
+    // access stored constants
+    double const& side      = node.storage(tags::side{});
+    double const& hue_scale = node.storage(tags::hue_scale{});
+    size_t const& devices   = node.storage(tags::devices{});
     // random walk
     rectangle_walk(CALL, make_vec(0,0,0), make_vec(side,side,height), node.storage(speed{}), 1);
     device_t src_id = 0;
@@ -169,28 +372,20 @@ MAIN() {
     node.storage(node_color{}) = color::hsva(ds*hue_scale, 1, 1);
     node.storage(node_shape{}) = is_src ? shape::cube : shape::icosahedron;
     node.storage(node_size{}) = is_src ? 16 : 10;
-    // spanning tree definition
+    // spanning tree definition, published to the oracle of ancestors (for statistics only)
     device_t parent = get<1>(min_hood(CALL, make_tuple(nbr(CALL, ds), node.nbr_uid())));
-    // routing sets along the tree
-    set_t below = sp_collection(CALL, ds, set_t{node.uid}, set_t{}, [](set_t x, set_t const& y){
-        x.insert(y.begin(), y.end());
-        return x;
-    });
-    // random message with 1% probability during time [10..50]
+    if (node.storage(tree{})) node.storage(tree{})->publish(node.uid, parent);
+    // routing summaries along the tree
+    R below = summary_collection<node_t, R>(CALL, ds, is_delta_encoded<R>{});
+    // random message with given probability (1% by default) during time [10..50]
     common::option<message> m;
-    if (node.current_time() > 10 and node.current_time() < 50 and node.next_real() < 0.01) {
+    if (node.current_time() > 10 and node.current_time() < 50 and node.next_real() < node.storage(rate{}) / 100) {
         m.emplace(node.uid, (device_t)node.next_int(devices-1), node.current_time());
         node.storage(sent_count{}) += 1;
     }
     // dispatches messages
     std::vector<color> procs{color(BLACK)};
-    map_t r = spawn(CALL, [&](message const& m){
-        procs.push_back(color::hsva(m.to*360.0/devices, 1, 1));
-        bool inpath = below.count(m.from) + below.count(m.to) > 0;
-        status s = node.uid == m.to ? status::terminated_output :
-                   inpath ? status::internal : status::border;
-        return make_tuple(node.current_time(), s);
-    }, m);
+    map_t r = dispatch(CALL, below, m, procs, std::integral_constant<bool, batched>{});
     // process and msg stats
     node.storage(max_proc{}) = max(node.storage(max_proc{}), procs.size() - 1);
     node.storage(tot_proc{}) += procs.size() - 1;
@@ -200,21 +395,200 @@ MAIN() {
     // additional node rendering
     node.storage(left_color{})  = procs[min(int(procs.size()), 2)-1];
     node.storage(right_color{}) = procs[min(int(procs.size()), 3)-1];
-    // persist received messages and delivery stats
-    r = old(CALL, map_t{}, [&](map_t m){
-        for (auto const& x : r) {
-            if (m.count(x.first)) node.storage(repeat_count{}) += 1;
-            else {
-                node.storage(first_delivery{}) += x.second - x.first.time;
-                node.storage(delivery_count{}) += 1;
-                m[x.first] = x.second;
-            }
-        }
-        return m;
-    });
+    // persist received messages (in place, within the retention window) and delivery stats
+    log_t& history = node.storage(delivered{});
+    history.evict(node.current_time());
+    for (auto const& x : r) {
+        if (history.expired(x.first)) node.storage(expired_count{}) += 1;
+        else if (history.insert(x.first)) {
+            node.storage(first_delivery{}) += x.second - x.first.time;
+            node.storage(delivery_count{}) += 1;
+        } else node.storage(repeat_count{}) += 1;
+    }
 }
-//! @brief Exports for the main function.
-FUN_EXPORT main_t = export_list<rectangle_walk_t<3>, bis_distance_t, sp_collection_t<double, set_t>, device_t, spawn_t<message, status>, map_t>;
+//! @brief Exports for the main function, parametrised by the routing summary type.
+template <typename R>
+using dispatch_main_t = export_list<rectangle_walk_t<3>, bis_distance_t, summary_collection_t<R>, device_t, dispatch_t>;
+//! @brief Exports for the main function (with exact routing sets).
+FUN_EXPORT main_t = dispatch_main_t<routing::exact>;
+
+
+}
+
+
+//! @brief Namespace for component options.
+namespace option {
+
+
+//! @brief Import tags to be used for component options.
+using namespace component::tags;
+//! @brief Import tags used by aggregate functions.
+using namespace coordination::tags;
+
+
+//! @brief Dimensionality of the space.
+constexpr size_t dim = 3;
+//! @brief The final simulation time.
+constexpr size_t end = 1000;
+
+//! @brief Average time of first delivery.
+struct avg_first_delivery {};
+
+//! @brief Total size of messages exchanged per unit of time.
+struct avg_msg_exchanged {};
+
+//! @brief Total active processes per unit of time.
+struct avg_active_proc {};
+
+//! @brief The randomised sequence of rounds for every node (about one every second, with 10% variance).
+using round_s = sequence::periodic<
+    distribution::interval_n<times_t, 0, 1>,
+    distribution::weibull_n<times_t, 10, 1, 10>,
+    distribution::constant_n<times_t, end+2>
+>;
+
+//! @brief The sequence of node generation events (multiple devices all generated at time 0).
+using spawn_s = sequence::multiple<
+    distribution::constant_i<size_t, devices>,
+    distribution::constant_n<double, 0>
+>;
+//! @brief The distribution of initial node positions (random in a given rectangle).
+using rectangle_d = distribution::rect<
+    distribution::constant_n<double, 0>,
+    distribution::constant_n<double, 0>,
+    distribution::constant_n<double, 0>,
+    distribution::constant_i<double, side>,
+    distribution::constant_i<double, side>,
+    distribution::constant_n<double, height>
+>;
+//! @brief The distribution of hue scale (all equal to a fixed value).
+using hue_d = functor::div<
+    distribution::constant_n<double, 360>,
+    functor::add<distribution::constant_i<double, side>, distribution::constant_n<double, height>>
+>;
+
+//! @brief The retention window of delivered messages (longer than the lifetime of any message).
+using retention_d = distribution::constant_n<times_t, 200>;
+
+//! @brief The tags and corresponding aggregators to be logged.
+using aggregator_t = aggregators<
+    max_msg,        aggregator::max<size_t>,
+    tot_msg,        aggregator::sum<size_t>,
+    max_proc,       aggregator::max<size_t>,
+    tot_proc,       aggregator::sum<size_t>,
+    first_delivery, aggregator::sum<double>,
+    sent_count,     aggregator::sum<size_t>,
+    delivery_count, aggregator::sum<size_t>,
+    repeat_count,   aggregator::sum<size_t>,
+    expired_count,  aggregator::sum<size_t>,
+    false_route,    aggregator::sum<size_t>
+>;
+
+//! @brief Lines of logged values.
+template <typename... Ts>
+using lines_t = plot::join<plot::values<aggregator_t, common::type_sequence<>, Ts>...>;
+//! @brief Rows of values computed by log functors.
+template <typename... Ts>
+using rows_t = plot::join<plot::value<Ts>...>;
+//! @brief Maximum message size and processes by time.
+using maxs_t = plot::filter<plot::time, filter::below<100>, plot::split<plot::time, lines_t<max_msg, max_proc>>>;
+//! @brief Average message size and processes per unit of time by time.
+using tots_t = plot::split<plot::time, rows_t<avg_msg_exchanged, avg_active_proc>>;
+//! @brief Message and routing counts by time.
+using counts_t = plot::split<plot::time, lines_t<sent_count, delivery_count, repeat_count, expired_count, false_route>>;
+//! @brief Average delivery time by time.
+using delay_t = plot::split<plot::time, rows_t<avg_first_delivery>>;
+//! @brief Combining the plots into a single row.
+using plot_t = plot::join<maxs_t, tots_t, counts_t, delay_t>;
+
+//! @brief The plots for every value of a swept parameter, filtering the other parameters.
+template <typename S, typename... Fs>
+using sweep_plot_t = plot::split<S, plot::filter<Fs..., plot_t>>;
+//! @brief The plots by devices, dens and rate, for the other parameters at their default values (300, 10, 1).
+using batch_plot_t = plot::join<
+    sweep_plot_t<devices, dens, filter::equal<10>, rate, filter::equal<1>>,
+    sweep_plot_t<dens, devices, filter::equal<300>, rate, filter::equal<1>>,
+    sweep_plot_t<rate, devices, filter::equal<300>, dens, filter::equal<10>>
+>;
+
+//! @brief The aggregator to be used on logging rows for plotting.
+using row_aggregator_t = common::type_sequence<aggregator::mean<double>>;
+//! @brief Message sizes and false routing by routing summary, after messages are sent (time above 50).
+using summary_plot_t = plot::split<summary, plot::filter<plot::time, filter::above<50>, plot::join<
+    plot::values<aggregator_t, row_aggregator_t, max_msg>,
+    plot::values<aggregator_t, row_aggregator_t, tot_msg>,
+    plot::values<aggregator_t, row_aggregator_t, false_route>
+>>>;
+
+//! @brief Process counts, message sizes and deliveries by dispatch mode, after messages are sent (time above 50).
+using multiplex_plot_t = plot::split<multiplexed, plot::filter<plot::time, filter::above<50>, plot::join<
+    plot::values<aggregator_t, row_aggregator_t, max_proc>,
+    plot::values<aggregator_t, row_aggregator_t, tot_proc>,
+    plot::values<aggregator_t, row_aggregator_t, tot_msg>,
+    plot::values<aggregator_t, row_aggregator_t, delivery_count, repeat_count, expired_count>
+>>>;
+
+//! @brief The general simulation options, parametrised by the routing summary, plot type, dispatch mode and multithreading on node rounds.
+template <typename R = routing::exact, typename P = plot_t, bool batched = false, bool threaded = true>
+DECLARE_OPTIONS(list,
+    parallel<threaded>,
+    synchronised<false>,
+    program<coordination::dispatch_main<R, batched>>,
+    exports<coordination::dispatch_main_t<R>>,
+    export_split<true>, // values kept by old are not sent to neighbours
+    round_schedule<round_s>,
+    log_schedule<sequence::periodic_n<1, 0, 1, end>>,
+    spawn_schedule<spawn_s>,
+    tuple_store<
+        speed,              double,
+        devices,            size_t,
+        side,               double,
+        hue_scale,          double,
+        rate,               double,
+        max_msg,            size_t,
+        tot_msg,            size_t,
+        max_proc,           size_t,
+        tot_proc,           size_t,
+        first_delivery,     times_t,
+        sent_count,         size_t,
+        delivery_count,     size_t,
+        repeat_count,       size_t,
+        expired_count,      size_t,
+        false_route,        size_t,
+        tree,               std::shared_ptr<tree_oracle>,
+        delivered,          coordination::log_t,
+        center_dist,        double,
+        node_color,         color,
+        left_color,         color,
+        right_color,        color,
+        node_size,          double,
+        node_shape,         shape
+    >,
+    aggregator_t,
+    log_functors<
+        avg_first_delivery, functor::div<aggregator::sum<first_delivery>, aggregator::sum<delivery_count>>,
+        avg_msg_exchanged,  functor::div<functor::diff<aggregator::sum<tot_msg>>, distribution::constant_i<double, devices>>,
+        avg_active_proc,    functor::div<functor::diff<aggregator::sum<tot_proc>>, distribution::constant_i<double, devices>>
+    >,
+    init<
+        x,                  rectangle_d,
+        speed,              distribution::constant_n<double, 1>,
+        devices,            distribution::constant_i<size_t, devices>,
+        side,               distribution::constant_i<double, side>,
+        hue_scale,          hue_d,
+        rate,               distribution::constant_i<double, rate>,
+        delivered,          retention_d,
+        tree,               distribution::constant_i<std::shared_ptr<tree_oracle>, tree>
+    >,
+    extra_info<summary, int, multiplexed, int, devices, double, dens, double, rate, double>,
+    plot_type<P>,
+    dimension<dim>,
+    connector<connect::fixed<comm, 1, dim>>,
+    message_size<true>,
+    shape_tag<node_shape>,
+    size_tag<node_size>,
+    color_tag<node_color, left_color, right_color>
+);
 
 
 }
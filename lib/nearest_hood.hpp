@@ -0,0 +1,109 @@
+// Copyright © 2026 Giorgio Audrito. All Rights Reserved.
+
+/**
+ * @file nearest_hood.hpp
+ * @brief Distance of the nearest neighbour and elastic springs towards the neighbourhood, in a single pass.
+ *
+ * Physics-style functions often need both the distance of the closest neighbour (as `min_hood` of `nbr_dist()`)
+ * and springs towards every neighbour (as `neighbour_elastic_force`). Computing them together while folding the
+ * neighbour vectors once avoids building the intermediate fields of distances and forces, with the same results.
+ */
+
+#ifndef FCPP_NEAREST_HOOD_H_
+#define FCPP_NEAREST_HOOD_H_
+
+#include <cmath>
+#include <limits>
+
+#include "lib/beautify.hpp"
+#include "lib/coordination.hpp"
+#include "lib/data/vec.hpp"
+
+
+/**
+ * @brief Namespace containing all the objects in the FCPP library.
+ */
+namespace fcpp {
+
+
+/**
+ * @brief The distance of the nearest neighbour and the force of elastic springs towards every neighbour.
+ *
+ * Springs have a given length and strength, and follow the law of `neighbour_elastic_force` (a neighbour at
+ * distance `d` along `v` contributes `v * strength * (d - length) / d`, nothing if `d` is zero).
+ *
+ * @param n The dimensionality of positions.
+ */
+template <size_t n>
+class hood_springs {
+  public:
+    //! @brief Constructor given the length and strength of springs.
+    hood_springs(real_t length, real_t strength) : m_length(length), m_strength(strength) {
+        for (size_t i = 0; i < n; ++i) m_force[i] = 0;
+    }
+
+    //! @brief Considers a neighbour given its position relative to the current device.
+    void insert(vec<n> const& v) {
+        real_t d2 = 0;
+        for (size_t i = 0; i < n; ++i) d2 += v[i] * v[i];
+        if (d2 == 0) {
+            m_closest = 0;
+            return;
+        }
+        real_t d = std::sqrt(d2);
+        if (d < m_closest) m_closest = d;
+        real_t c = m_strength * (d - m_length) / d;
+        for (size_t i = 0; i < n; ++i) m_force[i] += v[i] * c;
+    }
+
+    //! @brief The distance of the closest neighbour (the maximum real if there are no neighbours).
+    real_t closest() const {
+        return m_closest;
+    }
+
+    //! @brief The force of the springs towards every neighbour.
+    vec<n> const& elastic_force() const {
+        return m_force;
+    }
+
+  private:
+    //! @brief The length of springs.
+    real_t m_length;
+    //! @brief The strength of springs.
+    real_t m_strength;
+    //! @brief The distance of the closest neighbour.
+    real_t m_closest = std::numeric_limits<real_t>::max();
+    //! @brief The force of the springs considered.
+    vec<n> m_force;
+};
+
+
+//! @brief Namespace containing the libraries of coordination routines.
+namespace coordination {
+
+
+/**
+ * @brief The distance of the nearest neighbour and the springs towards the neighbourhood (excluding the device).
+ *
+ * The result is updated in place while folding the neighbour vectors, so that the neighbourhood is visited once
+ * with no intermediate fields. It equals `min_hood` of `nbr_dist()` and `neighbour_elastic_force` up to rounding.
+ */
+template <size_t n, typename node_t>
+hood_springs<n> nearest_hood(ARGS, real_t length, real_t strength) { CODE
+    hood_springs<n> s(length, strength);
+    fold_hood(CALL, [](vec<n> const& v, hood_springs<n>* p){
+        p->insert(v);
+        return p;
+    }, node.nbr_vec(), &s);
+    return s;
+}
+//! @brief Export list for nearest_hood.
+FUN_EXPORT nearest_hood_t = common::export_list<>;
+
+
+} // namespace coordination
+
+
+} // namespace fcpp
+
+#endif // FCPP_NEAREST_HOOD_H_
@@ -0,0 +1,237 @@
+// Copyright © 2026 Giorgio Audrito. All Rights Reserved.
+
+/**
+ * @file neighbour_list.hpp
+ * @brief Neighbour search among moving devices, through a cell grid rebuilt at every round or a Verlet list with a skin.
+ */
+
+#ifndef FCPP_NEIGHBOUR_LIST_H_
+#define FCPP_NEIGHBOUR_LIST_H_
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "lib/data/vec.hpp"
+
+
+/**
+ * @brief Namespace containing all the objects in the FCPP library.
+ */
+namespace fcpp {
+
+
+/**
+ * @brief Uniform grid of cells holding the indices of a set of positions, for finding neighbours within the cell size.
+ *
+ * Cells cover the bounding box of the positions, and their contents are stored contiguously (sorted by cell).
+ *
+ * @param n The dimensionality of positions.
+ */
+template <size_t n>
+class cell_grid {
+  public:
+    //! @brief Constructor given the cell size.
+    explicit cell_grid(double cell) : m_cell(cell) {}
+
+    //! @brief Fills the grid with given positions.
+    void build(std::vector<vec<n>> const& pos) {
+        m_lo.fill(INFINITY);
+        for (vec<n> const& p : pos) for (size_t k = 0; k < n; ++k) m_lo[k] = std::min(m_lo[k], p[k]);
+        size_t cells = 1;
+        for (size_t k = 0; k < n; ++k) {
+            double hi = -INFINITY;
+            for (vec<n> const& p : pos) hi = std::max(hi, p[k]);
+            m_size[k] = pos.empty() ? 1 : size_t((hi - m_lo[k]) / m_cell) + 1;
+            cells *= m_size[k];
+        }
+        m_start.assign(cells + 1, 0);
+        m_index.resize(pos.size());
+        for (size_t i = 0; i < pos.size(); ++i) ++m_start[cell_of(pos[i]) + 1];
+        for (size_t c = 0; c < cells; ++c) m_start[c+1] += m_start[c];
+        std::vector<uint32_t> fill(m_start.begin(), m_start.end() - 1);
+        for (size_t i = 0; i < pos.size(); ++i) m_index[fill[cell_of(pos[i])]++] = uint32_t(i);
+    }
+
+    //! @brief Calls `f(j)` for every index `j` in the cells around a position (within one cell in every direction).
+    template <typename F>
+    void for_each_candidate(vec<n> const& p, F&& f) const {
+        std::array<size_t, n> lo, hi, c;
+        for (size_t k = 0; k < n; ++k) {
+            size_t x = coordinate(p, k);
+            lo[k] = x > 0 ? x-1 : 0;
+            hi[k] = std::min(x+1, m_size[k]-1);
+            c[k] = lo[k];
+        }
+        while (true) {
+            size_t cell = 0;
+            for (size_t k = n; k-- > 0;) cell = cell * m_size[k] + c[k];
+            for (uint32_t i = m_start[cell]; i < m_start[cell+1]; ++i) f(size_t(m_index[i]));
+            size_t k = 0;
+            while (k < n and c[k] == hi[k]) c[k] = lo[k], ++k;
+            if (k == n) return;
+            ++c[k];
+        }
+    }
+
+    //! @brief Calls `f(j)` for every index `j ≠ i` whose position is within a radius (at most the cell size) from position `i`.
+    template <typename F>
+    void for_each_neighbour(size_t i, std::vector<vec<n>> const& pos, double radius, F&& f) const {
+        double r2 = radius * radius;
+        for_each_candidate(pos[i], [&](size_t j){
+            if (j != i and sqr_distance(pos[i], pos[j]) <= r2) f(j);
+        });
+    }
+
+    //! @brief The square distance between two positions.
+    static double sqr_distance(vec<n> const& a, vec<n> const& b) {
+        double d = 0;
+        for (size_t k = 0; k < n; ++k) d += (a[k] - b[k]) * (a[k] - b[k]);
+        return d;
+    }
+
+  private:
+    //! @brief The cell coordinate of a position along an axis (clamped to the grid).
+    size_t coordinate(vec<n> const& p, size_t k) const {
+        double x = std::floor((p[k] - m_lo[k]) / m_cell);
+        return x <= 0 ? 0 : std::min(size_t(x), m_size[k]-1);
+    }
+
+    //! @brief The cell of a position.
+    size_t cell_of(vec<n> const& p) const {
+        size_t cell = 0;
+        for (size_t k = n; k-- > 0;) cell = cell * m_size[k] + coordinate(p, k);
+        return cell;
+    }
+
+    //! @brief The cell size.
+    double m_cell;
+    //! @brief The lower corner of the grid.
+    std::array<double, n> m_lo;
+    //! @brief The number of cells along every axis.
+    std::array<size_t, n> m_size;
+    //! @brief The start of the contents of every cell in the index.
+    std::vector<uint32_t> m_start;
+    //! @brief The indices of positions, sorted by cell.
+    std::vector<uint32_t> m_index;
+};
+
+
+/**
+ * @brief Verlet neighbour list: candidate neighbours within `radius + skin`, rebuilt only when devices moved enough.
+ *
+ * The candidate lists are rebuilt (through a cell grid) when some device moved by more than `skin/2` since the last
+ * rebuild. Until then, two devices within `radius` must have been within `radius + skin` at the last rebuild, so
+ * filtering the candidates by distance finds exactly the neighbours a cell grid rebuilt from scratch would find.
+ * With devices moving at bounded speed, a rebuild happens every `skin / (2 speed)` time units.
+ *
+ * If candidate lists need a rebuild within two updates, they cost more than a plain cell grid (which is smaller).
+ * In that case, the list falls back to a cell grid of size `radius` rebuilt at every update, until devices move by
+ * less than `skin/8` between consecutive updates (so that candidate lists would last at least four updates).
+ *
+ * FCPP's simulated connector keeps its own cells, so the list is not a connector option. Against a model of the
+ * search of `connect::fixed` (see `neighbour_list_benchmark`), it is 1.5-3 times faster with static devices, and
+ * between half and the same speed with moving devices.
+ *
+ * @param n The dimensionality of positions.
+ */
+template <size_t n>
+class verlet_list {
+  public:
+    //! @brief Constructor given the connection radius and the skin.
+    verlet_list(double radius, double skin) : m_radius(radius), m_skin(skin), m_grid(radius + skin), m_direct_grid(radius) {}
+
+    //! @brief Updates the list to new positions (of the same devices), returning whether a grid was rebuilt.
+    bool update(std::vector<vec<n>> const& pos) {
+        if (pos.size() == m_built.size() and m_direct) {
+            double d2 = max_sqr_distance(pos, m_built);
+            m_built = pos;
+            if (64 * d2 > m_skin * m_skin) {
+                ++m_rebuilds;
+                m_direct_grid.build(pos);
+                return true;
+            }
+            m_direct = false;
+        } else if (pos.size() == m_built.size()) {
+            ++m_age;
+            if (4 * max_sqr_distance(pos, m_built) <= m_skin * m_skin) return false;
+            if (m_age <= 2) {
+                ++m_rebuilds;
+                m_direct = true;
+                m_built = pos;
+                m_direct_grid.build(pos);
+                return true;
+            }
+        }
+        rebuild(pos);
+        return true;
+    }
+
+    //! @brief Calls `f(j)` for every neighbour `j` of device `i`, given the current positions.
+    template <typename F>
+    void for_each_neighbour(size_t i, std::vector<vec<n>> const& pos, F&& f) const {
+        if (m_direct) return m_direct_grid.for_each_neighbour(i, pos, m_radius, f);
+        double r2 = m_radius * m_radius;
+        for (uint32_t k = m_start[i]; k < m_start[i+1]; ++k) {
+            size_t j = m_candidates[k];
+            if (cell_grid<n>::sqr_distance(pos[i], pos[j]) <= r2) f(j);
+        }
+    }
+
+    //! @brief The number of grid rebuilds performed (for candidate lists or direct search).
+    size_t rebuilds() const {
+        return m_rebuilds;
+    }
+
+  private:
+    //! @brief The maximum square distance between corresponding positions.
+    static double max_sqr_distance(std::vector<vec<n>> const& a, std::vector<vec<n>> const& b) {
+        double d2 = 0;
+        for (size_t i = 0; i < a.size(); ++i) d2 = std::max(d2, cell_grid<n>::sqr_distance(a[i], b[i]));
+        return d2;
+    }
+
+    //! @brief Rebuilds the candidate lists.
+    void rebuild(std::vector<vec<n>> const& pos) {
+        ++m_rebuilds;
+        m_age = 0;
+        m_built = pos;
+        m_grid.build(pos);
+        m_start.assign(1, 0);
+        m_candidates.clear();
+        for (size_t i = 0; i < pos.size(); ++i) {
+            m_grid.for_each_neighbour(i, pos, m_radius + m_skin, [&](size_t j){
+                m_candidates.push_back(uint32_t(j));
+            });
+            m_start.push_back(uint32_t(m_candidates.size()));
+        }
+    }
+
+    //! @brief The connection radius.
+    double m_radius;
+    //! @brief The skin.
+    double m_skin;
+    //! @brief The grid used for rebuilds.
+    cell_grid<n> m_grid;
+    //! @brief The grid used for direct search.
+    cell_grid<n> m_direct_grid;
+    //! @brief Whether direct search is used instead of candidate lists.
+    bool m_direct = false;
+    //! @brief The number of updates since the last rebuild of candidate lists.
+    size_t m_age = 0;
+    //! @brief The positions at the last rebuild of candidate lists (at the last update during direct search).
+    std::vector<vec<n>> m_built;
+    //! @brief The start of the candidates of every device.
+    std::vector<uint32_t> m_start;
+    //! @brief The candidates of every device, contiguously.
+    std::vector<uint32_t> m_candidates;
+    //! @brief The number of rebuilds performed.
+    size_t m_rebuilds = 0;
+};
+
+
+} // namespace fcpp
+
+#endif // FCPP_NEIGHBOUR_LIST_H_
@@ -0,0 +1,122 @@
+// Copyright © 2026 Giorgio Audrito. All Rights Reserved.
+
+/**
+ * @file obstacle_cache.hpp
+ * @brief On-disk cache of obstacle maps, keyed on the floor plan image, the obstacle color threshold and the grid.
+ */
+
+#ifndef FCPP_OBSTACLE_CACHE_H_
+#define FCPP_OBSTACLE_CACHE_H_
+
+#include <sys/stat.h>
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "lib/flat_hash.hpp"
+#include "lib/obstacle_map.hpp"
+
+
+/**
+ * @brief Namespace containing all the objects in the FCPP library.
+ */
+namespace fcpp {
+
+
+/**
+ * @brief Cache of the obstacle map of a floor plan image, stored as a file in a directory.
+ *
+ * The map is keyed on a hash of the contents of the image, together with the color threshold and the grid of the
+ * map. If the directory holds a map with the same key, it is memory-mapped at construction, so that neither the
+ * image nor the map need to be computed. Otherwise, the map is computed at the first request and written to the
+ * directory for later executions. If the image cannot be read, maps are computed at every execution.
+ *
+ * @param n The dimensionality of positions.
+ */
+template <size_t n>
+class obstacle_cache {
+  public:
+    //! @brief Constructor given the cache directory (created if missing), the image, threshold, and area and cell of the map.
+    obstacle_cache(std::string dir, std::string const& image, double threshold, std::array<double, 2> lo, std::array<double, 2> hi, double cell)
+    : m_lo(lo), m_hi(hi), m_cell(cell) {
+        std::ifstream f(image, std::ios::binary);
+        if (not f) return;
+        uint64_t h = 0xcbf29ce484222325ULL;
+        char buf[1 << 16];
+        while (f.read(buf, sizeof(buf)) or f.gcount() > 0)
+            for (std::streamsize i = 0; i < f.gcount(); ++i) h = (h ^ uint8_t(buf[i])) * 0x100000001b3ULL;
+        for (double x : {threshold, lo[0], lo[1], hi[0], hi[1], cell}) h = hash_combine(h, hash_bits(x));
+        m_key = hash_mix(h) | 1;
+        char s[17];
+        std::snprintf(s, sizeof(s), "%016llx", (unsigned long long)m_key);
+        mkdir(dir.c_str(), 0755);
+        m_path = dir + "/" + s + ".obm";
+        m_hit = m_map.load(m_path, m_key);
+    }
+
+    //! @brief Copies are not allowed.
+    obstacle_cache(obstacle_cache const&) = delete;
+
+    //! @brief The key of the map (zero if the image could not be read).
+    uint64_t key() const {
+        return m_key;
+    }
+
+    //! @brief Whether the map was found in the cache.
+    bool hit() const {
+        return m_hit;
+    }
+
+    //! @brief Whether the map is available without sampling (found in the cache or already computed).
+    bool ready() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return bool(m_map);
+    }
+
+    /**
+     * @brief The obstacle map, computed by sampling an obstacle predicate if missing from the cache.
+     *
+     * The predicate is called as `f(x, y)` with the planar coordinates of a cell centre, and should reflect the
+     * image and threshold given at construction.
+     */
+    template <typename F>
+    obstacle_map<n> const& map(F&& f) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_map) return m_map;
+        m_map = obstacle_map<n>(m_lo, m_hi, m_cell, f);
+        if (m_key == 0) return m_map;
+        std::string tmp = m_path + ".tmp" + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+        if (m_map.write(tmp, m_key)) std::rename(tmp.c_str(), m_path.c_str());
+        else std::remove(tmp.c_str());
+        return m_map;
+    }
+
+  private:
+    //! @brief The lower corner of the area.
+    std::array<double, 2> m_lo;
+    //! @brief The upper corner of the area.
+    std::array<double, 2> m_hi;
+    //! @brief The side of a cell.
+    double m_cell;
+    //! @brief The key of the map.
+    uint64_t m_key = 0;
+    //! @brief The path of the cache file.
+    std::string m_path;
+    //! @brief Whether the map was found in the cache.
+    bool m_hit = false;
+    //! @brief The map.
+    obstacle_map<n> m_map;
+    //! @brief Mutex serialising the computation of the map.
+    std::mutex m_mutex;
+};
+
+
+} // namespace fcpp
+
+#endif // FCPP_OBSTACLE_CACHE_H_
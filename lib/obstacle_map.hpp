@@ -0,0 +1,373 @@
+// Copyright © 2026 Giorgio Audrito. All Rights Reserved.
+
+/**
+ * @file obstacle_map.hpp
+ * @brief Grid of obstacles on a planar area, with constant-time nearest obstacle and free space queries through a precomputed Euclidean feature transform.
+ */
+
+#ifndef FCPP_OBSTACLE_MAP_H_
+#define FCPP_OBSTACLE_MAP_H_
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "lib/data/vec.hpp"
+
+
+/**
+ * @brief Namespace containing all the objects in the FCPP library.
+ */
+namespace fcpp {
+
+
+/**
+ * @brief Grid of square cells on the first two coordinates of an area, each either obstacle or free space.
+ *
+ * At construction, the map computes the exact Euclidean distance transform of the grid, both towards obstacles and
+ * towards free space, and keeps for every cell the index of the nearest cell of either kind (measuring distances
+ * between cell centres). Queries then cost a constant number of lookups, independently of how far the nearest
+ * obstacle is. Positions outside the area are treated as in the nearest cell of the border.
+ *
+ * The map is stored in a single immutable block (a header, the bit-packed obstacle cells, and the nearest cells),
+ * shared by copies of the map. The block can be written to a file as is, and later memory-mapped in place of
+ * being computed again.
+ *
+ * @param n The dimensionality of positions (coordinates beyond the first two are preserved by queries).
+ */
+template <size_t n>
+class obstacle_map {
+    static_assert(n >= 2, "obstacle maps need at least two dimensions");
+
+  public:
+    //! @brief Value marking the absence of a cell.
+    static constexpr uint32_t none = std::numeric_limits<uint32_t>::max();
+
+    //! @brief Empty map.
+    obstacle_map() = default;
+
+    /**
+     * @brief Constructor given the lower corner, the cell side, the number of columns and rows, and the obstacle cells.
+     *
+     * Cells are given row by row, starting from the lower corner.
+     */
+    obstacle_map(std::array<double, 2> lo, double cell, size_t cols, size_t rows, std::vector<bool> const& obstacle)
+    : m_lo(lo), m_cell(cell), m_cols(cols), m_rows(rows) {
+        char* base = allocate();
+        uint64_t* bits = reinterpret_cast<uint64_t*>(base + sizeof(header));
+        for (size_t c = 0; c < std::min(obstacle.size(), m_cols * m_rows); ++c)
+            if (obstacle[c]) bits[c >> 6] |= uint64_t(1) << (c & 63);
+        build(base);
+    }
+
+    /**
+     * @brief Constructor sampling an obstacle predicate at the centre of every cell covering an area.
+     *
+     * The predicate is called as `f(x, y)` with the planar coordinates of a cell centre.
+     */
+    template <typename F>
+    obstacle_map(std::array<double, 2> lo, std::array<double, 2> hi, double cell, F&& f)
+    : m_lo(lo), m_cell(cell) {
+        m_cols = std::max<size_t>(std::ceil((hi[0] - lo[0]) / cell), 1);
+        m_rows = std::max<size_t>(std::ceil((hi[1] - lo[1]) / cell), 1);
+        char* base = allocate();
+        uint64_t* bits = reinterpret_cast<uint64_t*>(base + sizeof(header));
+        for (size_t y = 0; y < m_rows; ++y)
+            for (size_t x = 0; x < m_cols; ++x)
+                if (f(lo[0] + (x + 0.5) * cell, lo[1] + (y + 0.5) * cell)) {
+                    size_t c = y * m_cols + x;
+                    bits[c >> 6] |= uint64_t(1) << (c & 63);
+                }
+        build(base);
+    }
+
+    //! @brief Whether the map is not empty.
+    explicit operator bool() const {
+        return m_cols * m_rows > 0;
+    }
+
+    //! @brief The lower corner of the area.
+    std::array<double, 2> const& lower() const {
+        return m_lo;
+    }
+
+    //! @brief The side of a cell.
+    double cell() const {
+        return m_cell;
+    }
+
+    //! @brief The number of columns.
+    size_t cols() const {
+        return m_cols;
+    }
+
+    //! @brief The number of rows.
+    size_t rows() const {
+        return m_rows;
+    }
+
+    //! @brief The size in bytes of the block storing the map.
+    size_t bytes() const {
+        return bytes_for(m_cols * m_rows);
+    }
+
+    //! @brief Whether a cell is an obstacle.
+    bool obstacle(uint32_t c) const {
+        return (m_bits[c >> 6] >> (c & 63)) & 1;
+    }
+
+    //! @brief The cell of a position.
+    uint32_t cell_of(vec<n> const& p) const {
+        return uint32_t(coordinate(p[1], 1, m_rows) * m_cols + coordinate(p[0], 0, m_cols));
+    }
+
+    //! @brief Whether a position is on an obstacle.
+    bool is_obstacle(vec<n> const& p) const {
+        return obstacle(cell_of(p));
+    }
+
+    //! @brief The nearest obstacle cell to the cell of a position (`none` if there are no obstacles).
+    uint32_t nearest_obstacle(vec<n> const& p) const {
+        return m_nearest_obstacle[cell_of(p)];
+    }
+
+    //! @brief The nearest free cell to the cell of a position (`none` if there is no free space).
+    uint32_t nearest_space(vec<n> const& p) const {
+        return m_nearest_space[cell_of(p)];
+    }
+
+    //! @brief The closest point of the nearest obstacle cell to a position (infinitely far if there are no obstacles).
+    vec<n> closest_obstacle(vec<n> const& p) const {
+        return closest_point(p, nearest_obstacle(p));
+    }
+
+    //! @brief The closest point of the nearest free cell to a position (the position itself if there is no free space).
+    vec<n> closest_space(vec<n> const& p) const {
+        uint32_t c = nearest_space(p);
+        return c == none ? p : closest_point(p, c);
+    }
+
+    //! @brief The distance from a position to the nearest obstacle (zero on obstacles, infinite if there are none).
+    real_t obstacle_distance(vec<n> const& p) const {
+        return distance(p, closest_obstacle(p));
+    }
+
+    //! @brief Writes the map to a file, marked with a given key, returning whether it succeeded.
+    bool write(std::string const& path, uint64_t key) const {
+        if (not *this) return false;
+        header h = *m_header;
+        h.key = key;
+        std::ofstream f(path, std::ios::binary | std::ios::trunc);
+        f.write(reinterpret_cast<char const*>(&h), sizeof(header));
+        f.write(reinterpret_cast<char const*>(m_header) + sizeof(header), bytes() - sizeof(header));
+        return f.good();
+    }
+
+    /**
+     * @brief Memory-maps a map from a file written with a given key, returning whether it succeeded.
+     *
+     * Fails (leaving the map unchanged) if the file is missing, truncated, or written by a different format or key.
+     */
+    bool load(std::string const& path, uint64_t key) {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat s;
+        void* p = MAP_FAILED;
+        if (fstat(fd, &s) == 0 and size_t(s.st_size) >= sizeof(header))
+            p = mmap(nullptr, s.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (p == MAP_FAILED) return false;
+        size_t size = s.st_size;
+        std::shared_ptr<void const> owner(p, [size](void const* q){
+            munmap(const_cast<void*>(q), size);
+        });
+        header const& h = *static_cast<header const*>(p);
+        if (h.magic != magic or h.key != key or h.cols * h.rows > none or size != bytes_for(h.cols * h.rows)) return false;
+        m_owner = std::move(owner);
+        m_lo = {h.lo[0], h.lo[1]};
+        m_cell = h.cell;
+        m_cols = h.cols;
+        m_rows = h.rows;
+        point(static_cast<char const*>(p));
+        return true;
+    }
+
+  private:
+    //! @brief The header of the block storing the map.
+    struct header {
+        //! @brief Identifier of the format.
+        uint64_t magic;
+        //! @brief Key identifying the source of the map.
+        uint64_t key;
+        //! @brief The number of columns and rows.
+        uint64_t cols, rows;
+        //! @brief The lower corner of the area.
+        double lo[2];
+        //! @brief The side of a cell.
+        double cell;
+        //! @brief Unused (pads the header to 64 bytes).
+        uint64_t padding;
+    };
+
+    //! @brief Identifier of the format ("FCPPOBM1" in little-endian).
+    static constexpr uint64_t magic = 0x314d424f50504346ULL;
+
+    //! @brief The distance value for cells with no site.
+    static constexpr double far = 1e20;
+
+    //! @brief The size in bytes of the block storing a map with a given number of cells.
+    static size_t bytes_for(size_t cells) {
+        return sizeof(header) + (cells + 63) / 64 * sizeof(uint64_t) + 2 * cells * sizeof(uint32_t);
+    }
+
+    //! @brief Allocates a zeroed block for the map, returning its base.
+    char* allocate() {
+        auto block = std::make_shared<std::vector<uint64_t>>((bytes_for(m_cols * m_rows) + 7) / 8);
+        char* base = reinterpret_cast<char*>(block->data());
+        header& h = *reinterpret_cast<header*>(base);
+        h.magic = magic;
+        h.cols = m_cols;
+        h.rows = m_rows;
+        h.lo[0] = m_lo[0];
+        h.lo[1] = m_lo[1];
+        h.cell = m_cell;
+        m_owner = std::move(block);
+        point(base);
+        return base;
+    }
+
+    //! @brief Points the map to the contents of a block.
+    void point(char const* base) {
+        m_header = reinterpret_cast<header const*>(base);
+        m_bits = reinterpret_cast<uint64_t const*>(base + sizeof(header));
+        m_nearest_obstacle = reinterpret_cast<uint32_t const*>(m_bits + (m_cols * m_rows + 63) / 64);
+        m_nearest_space = m_nearest_obstacle + m_cols * m_rows;
+    }
+
+    //! @brief The cell coordinate of a planar coordinate along an axis with given size.
+    size_t coordinate(real_t v, size_t axis, size_t size) const {
+        double x = std::floor((v - m_lo[axis]) / m_cell);
+        return x <= 0 ? 0 : std::min(size_t(x), size - 1);
+    }
+
+    //! @brief The closest point of a cell to a position (infinitely far if the cell is missing).
+    vec<n> closest_point(vec<n> p, uint32_t c) const {
+        if (c == none) {
+            p[0] = p[1] = INFINITY;
+            return p;
+        }
+        double x = m_lo[0] + (c % m_cols) * m_cell, y = m_lo[1] + (c / m_cols) * m_cell;
+        p[0] = std::min(std::max(double(p[0]), x), x + m_cell);
+        p[1] = std::min(std::max(double(p[1]), y), y + m_cell);
+        return p;
+    }
+
+    /**
+     * @brief One-dimensional squared distance transform with the lower envelope of parabolas (Felzenszwalb and Huttenlocher).
+     *
+     * Computes `d[q] = min_p (q-p)^2 + f[p]` and the minimising `p` in `arg[q]`, for `q` and `p` in `[0, len)`.
+     */
+    static void transform(size_t len, std::vector<double> const& f, std::vector<double>& d, std::vector<uint32_t>& arg, std::vector<uint32_t>& v, std::vector<double>& z) {
+        size_t k = 0;
+        v[0] = 0;
+        z[0] = -INFINITY;
+        z[1] = +INFINITY;
+        for (size_t q = 1; q < len; ++q) {
+            double s;
+            while (true) {
+                size_t p = v[k];
+                s = ((f[q] + double(q)*q) - (f[p] + double(p)*p)) / (2.0*q - 2.0*p);
+                if (s > z[k]) break;
+                --k;
+            }
+            ++k;
+            v[k] = uint32_t(q);
+            z[k] = s;
+            z[k+1] = +INFINITY;
+        }
+        k = 0;
+        for (size_t q = 0; q < len; ++q) {
+            while (z[k+1] < q) ++k;
+            size_t p = v[k];
+            d[q] = (double(q) - p) * (double(q) - p) + f[p];
+            arg[q] = uint32_t(p);
+        }
+    }
+
+    //! @brief Computes the nearest cell with a given value for every cell, through a transform along columns and then rows.
+    void feature_transform(bool site, uint32_t* nearest) const {
+        size_t len = std::max(m_cols, m_rows);
+        std::vector<double> f(len), d(len), z(len + 1), g(m_cols * m_rows);
+        std::vector<uint32_t> arg(len), v(len), row(m_cols * m_rows);
+        for (size_t x = 0; x < m_cols; ++x) {
+            for (size_t y = 0; y < m_rows; ++y) f[y] = obstacle(uint32_t(y * m_cols + x)) == site ? 0 : far;
+            transform(m_rows, f, d, arg, v, z);
+            for (size_t y = 0; y < m_rows; ++y) {
+                g[y * m_cols + x] = d[y];
+                row[y * m_cols + x] = arg[y];
+            }
+        }
+        for (size_t y = 0; y < m_rows; ++y) {
+            for (size_t x = 0; x < m_cols; ++x) f[x] = g[y * m_cols + x];
+            transform(m_cols, f, d, arg, v, z);
+            for (size_t x = 0; x < m_cols; ++x) {
+                size_t c = arg[x];
+                nearest[y * m_cols + x] = d[x] < far ? uint32_t(row[y * m_cols + c] * m_cols + c) : none;
+            }
+        }
+    }
+
+    //! @brief Computes the nearest obstacle and free cells in a block whose obstacle cells are set.
+    void build(char* base) const {
+        uint32_t* nearest = reinterpret_cast<uint32_t*>(base) + (m_nearest_obstacle - reinterpret_cast<uint32_t const*>(base));
+        feature_transform(true, nearest);
+        feature_transform(false, nearest + m_cols * m_rows);
+    }
+
+    //! @brief The lower corner of the area.
+    std::array<double, 2> m_lo = {0, 0};
+    //! @brief The side of a cell.
+    double m_cell = 1;
+    //! @brief The number of columns.
+    size_t m_cols = 0;
+    //! @brief The number of rows.
+    size_t m_rows = 0;
+    //! @brief The owner of the block storing the map (a vector or a memory mapping).
+    std::shared_ptr<void const> m_owner;
+    //! @brief The header of the block.
+    header const* m_header = nullptr;
+    //! @brief The obstacle cells, one bit per cell.
+    uint64_t const* m_bits = nullptr;
+    //! @brief The nearest obstacle cell to every cell.
+    uint32_t const* m_nearest_obstacle = nullptr;
+    //! @brief The nearest free cell to every cell.
+    uint32_t const* m_nearest_space = nullptr;
+};
+
+
+//! @cond INTERNAL
+template <size_t n>
+constexpr uint32_t obstacle_map<n>::none;
+
+template <size_t n>
+constexpr uint64_t obstacle_map<n>::magic;
+
+template <size_t n>
+constexpr double obstacle_map<n>::far;
+//! @endcond
+
+
+} // namespace fcpp
+
+#endif // FCPP_OBSTACLE_MAP_H_
@@ -0,0 +1,128 @@
+// Copyright © 2026 Giorgio Audrito. All Rights Reserved.
+
+/**
+ * @file plot_compare.hpp
+ * @brief Comparison of printed plots up to a numeric tolerance.
+ */
+
+#ifndef FCPP_PLOT_COMPARE_H_
+#define FCPP_PLOT_COMPARE_H_
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <ostream>
+#include <string>
+
+
+/**
+ * @brief Namespace containing all the objects in the FCPP library.
+ */
+namespace fcpp {
+
+
+//! @brief Namespace for all plotting utilities.
+namespace plot {
+
+
+//! @brief Result of the comparison of two printed plots.
+struct comparison {
+    //! @brief Whether the plots match.
+    bool match = true;
+    //! @brief The number of numeric values compared.
+    size_t numbers = 0;
+    //! @brief The largest relative difference among the numeric values compared.
+    double max_error = 0;
+    //! @brief The line of the first mismatch (starting from 1).
+    size_t line = 0;
+    //! @brief The text of the first plot around the first mismatch.
+    std::string first;
+    //! @brief The text of the second plot around the first mismatch.
+    std::string second;
+
+    //! @brief Whether the plots match.
+    explicit operator bool() const {
+        return match;
+    }
+
+    //! @brief Prints the comparison on a given stream.
+    friend std::ostream& operator<<(std::ostream& o, comparison const& c) {
+        o << c.numbers << " numbers compared, maximum relative error " << c.max_error;
+        if (c.match) return o;
+        return o << ", first mismatch at line " << c.line << ": \"" << c.first << "\" vs \"" << c.second << "\"";
+    }
+};
+
+
+//! @cond INTERNAL
+namespace details {
+    //! @brief Whether a number starts at a given position of a string.
+    inline bool number_start(std::string const& s, size_t i) {
+        if (i > 0 and (std::isalnum((unsigned char)s[i-1]) or s[i-1] == '_' or s[i-1] == '.')) return false;
+        if (s[i] == '-' or s[i] == '+') ++i;
+        if (i < s.size() and s[i] == '.') ++i;
+        if (i < s.size() and std::isdigit((unsigned char)s[i])) return true;
+        return s.compare(i, 3, "inf") == 0 or s.compare(i, 3, "nan") == 0;
+    }
+
+    //! @brief The text around a position of a string.
+    inline std::string context(std::string const& s, size_t i) {
+        size_t b = s.rfind('\n', i == 0 ? 0 : i-1);
+        b = b == std::string::npos ? 0 : b+1;
+        return s.substr(b, std::min<size_t>(s.find('\n', i), s.size()) - b);
+    }
+}
+//! @endcond
+
+
+/**
+ * @brief Compares two printed plots, with numeric values matching up to a relative or absolute tolerance.
+ *
+ * The text outside numeric values should be identical. Numbers match if they differ by at most `rel_tol` times
+ * the larger absolute value, or by at most `abs_tol`. Infinite values match if equal, and not-a-number values match
+ * each other. This makes the comparison independent from the printing precision and from rounding differences due
+ * to the order in which rows are aggregated.
+ */
+inline comparison compare(std::string const& a, std::string const& b, double rel_tol = 1e-6, double abs_tol = 1e-12) {
+    comparison c;
+    size_t i = 0, j = 0, line = 1;
+    while (i < a.size() and j < b.size()) {
+        if (details::number_start(a, i) and details::number_start(b, j)) {
+            char* ea;
+            char* eb;
+            double x = std::strtod(a.c_str() + i, &ea);
+            double y = std::strtod(b.c_str() + j, &eb);
+            size_t ni = ea - a.c_str(), nj = eb - b.c_str();
+            if (ni > i and nj > j) {
+                ++c.numbers;
+                bool same = (std::isnan(x) and std::isnan(y)) or x == y;
+                double d = std::abs(x - y), m = std::max(std::abs(x), std::abs(y));
+                if (not same and std::isfinite(d)) c.max_error = std::max(c.max_error, d / m);
+                if (not same and not (std::isfinite(d) and (d <= abs_tol or d <= rel_tol * m))) break;
+                i = ni;
+                j = nj;
+                continue;
+            }
+        }
+        if (a[i] != b[j]) break;
+        line += a[i] == '\n';
+        ++i;
+        ++j;
+    }
+    if (i < a.size() or j < b.size()) {
+        c.match = false;
+        c.line = line;
+        c.first = details::context(a, i);
+        c.second = details::context(b, j);
+    }
+    return c;
+}
+
+
+} // namespace plot
+
+
+} // namespace fcpp
+
+#endif // FCPP_PLOT_COMPARE_H_
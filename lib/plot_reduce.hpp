@@ -0,0 +1,77 @@
+// Copyright © 2026 Giorgio Audrito. All Rights Reserved.
+
+/**
+ * @file plot_reduce.hpp
+ * @brief Merge of the plotters of MPI processes through a binary tree reduction.
+ */
+
+#ifndef FCPP_PLOT_REDUCE_H_
+#define FCPP_PLOT_REDUCE_H_
+
+#include <utility>
+#include <vector>
+
+#ifdef FCPP_MPI
+#include <mpi.h>
+#endif
+
+#include "lib/common/serialize.hpp"
+
+
+/**
+ * @brief Namespace containing all the objects in the FCPP library.
+ */
+namespace fcpp {
+
+
+//! @brief Namespace containing tools for batch execution of simulations.
+namespace batch {
+
+
+/**
+ * @brief Merges the plotters of every MPI process into the plotter of process 0, through a binary tree reduction.
+ *
+ * At step `k`, a process whose rank is an odd multiple of `2^k` sends its (partially merged) plotter to the process
+ * `2^k` ranks below, while a process whose rank is a multiple of `2^(k+1)` merges the plotter received from the process
+ * `2^k` ranks above. The merge takes `log2(n)` steps instead of the `n-1` receives serialised at the master by a flat
+ * gather, and every process sends its plotter at most once. Plotters are exchanged through their binary
+ * serialisation, and merged with `+=`. Every process should call this function. Without MPI, it does nothing.
+ */
+template <typename P>
+void tree_reduce(P& p, int tag = 1431) {
+#ifdef FCPP_MPI
+    int rank, n_procs;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &n_procs);
+    for (int step = 1; step < n_procs; step *= 2) {
+        if (rank % (2*step) != 0) {
+            common::osstream os;
+            os << p;
+            MPI_Send(os.data().data(), os.data().size(), MPI_CHAR, rank - step, tag, MPI_COMM_WORLD);
+            return;
+        }
+        if (rank + step >= n_procs) continue;
+        MPI_Status status;
+        int size;
+        MPI_Probe(rank + step, tag, MPI_COMM_WORLD, &status);
+        MPI_Get_count(&status, MPI_CHAR, &size);
+        std::vector<char> data(size);
+        MPI_Recv(data.data(), size, MPI_CHAR, rank + step, tag, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+        common::isstream is(std::move(data));
+        P q;
+        is >> q;
+        p += q;
+    }
+#else
+    (void)p;
+    (void)tag;
+#endif
+}
+
+
+} // namespace batch
+
+
+} // namespace fcpp
+
+#endif // FCPP_PLOT_REDUCE_H_
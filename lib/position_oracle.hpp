@@ -0,0 +1,170 @@
+// Copyright © 2026 Giorgio Audrito. All Rights Reserved.
+
+/**
+ * @file position_oracle.hpp
+ * @brief Ground-truth oracle computing the position of a device once per time (or time quantum), shared by every node of a network.
+ */
+
+#ifndef FCPP_POSITION_ORACLE_H_
+#define FCPP_POSITION_ORACLE_H_
+
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+#include "lib/settings.hpp"
+#include "lib/common/mutex.hpp"
+#include "lib/data/vec.hpp"
+
+
+/**
+ * @brief Namespace containing all the objects in the FCPP library.
+ */
+namespace fcpp {
+
+
+//! @cond INTERNAL
+namespace details {
+    //! @brief The position of a device at a given time, read with the device locked (networks locking nodes).
+    template <typename N>
+    auto locked_position(N& net, device_t id, times_t t, int) -> decltype(net.node_at(id, std::declval<common::unique_lock<true>&>()).position(t)) {
+        common::unique_lock<true> l;
+        return net.node_at(id, l).position(t);
+    }
+
+    //! @brief The position of a device at a given time (networks not locking nodes).
+    template <typename N>
+    auto locked_position(N& net, device_t id, times_t t, long) -> decltype(net.node_at(id).position(t)) {
+        return net.node_at(id).position(t);
+    }
+}
+//! @endcond
+
+
+//! @brief The position of a device at a given time, read with the device locked so that its round cannot run meanwhile (the position of the caller if the device does not exist).
+template <size_t n, typename node_t>
+vec<n> device_position(node_t& node, device_t id, times_t t) {
+    if (id == node.uid) return node.position(t);
+    if (node.net.node_count(id) == 0) return node.position(t);
+    return details::locked_position(node.net, id, t, 0);
+}
+
+
+/**
+ * @brief Oracle serving the true position of a device to every node of a network.
+ *
+ * The position is computed by the first node asking for it in a time quantum, reading the device with its
+ * lock held, and then served to the other nodes asking in the same quantum without locking (through a sequence
+ * counter over atomic fields). Times are rounded down to the start of their quantum, so that a single
+ * computation is shared by every round in the quantum, and the position is off by up to one quantum of motion
+ * of the device. The default quantum is the average round period (one second); with no quantum, positions are
+ * exact but hardly shared, as rounds on randomised schedules have different times. A device asking for its own
+ * position gets it directly. Meant to be shared among the nodes of a single network (e.g. through a
+ * `std::shared_ptr` in the node storage).
+ *
+ * @param n The dimensionality of positions.
+ */
+template <size_t n>
+class position_oracle {
+  public:
+    //! @brief Constructor given the time quantum (zero for exact positions).
+    explicit position_oracle(times_t quantum = 1) : m_quantum(quantum) {
+        for (auto& x : m_pos) x.store(0, std::memory_order_relaxed);
+    }
+
+    //! @brief The time quantum.
+    times_t quantum() const {
+        return m_quantum;
+    }
+
+    //! @brief The number of positions served from a previous computation.
+    size_t hits() const {
+        return m_hits.load(std::memory_order_relaxed);
+    }
+
+    //! @brief The number of positions computed.
+    size_t misses() const {
+        return m_misses.load(std::memory_order_relaxed);
+    }
+
+    //! @brief The position of a device at the start of the quantum of the current time (the position of the caller if the device does not exist).
+    template <typename node_t>
+    vec<n> position(node_t& node, device_t id) {
+        if (id == node.uid) return node.position();
+        times_t t = m_quantum > 0 ? std::floor(node.current_time() / m_quantum) * m_quantum : node.current_time();
+        vec<n> pos;
+        bool found;
+        if (not read(t, id, pos, found)) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (not read(t, id, pos, found)) {
+                found = node.net.node_count(id) > 0;
+                if (found) pos = details::locked_position(node.net, id, t, 0);
+                write(t, id, pos, found);
+                m_misses.fetch_add(1, std::memory_order_relaxed);
+                return found ? pos : node.position();
+            }
+        }
+        m_hits.fetch_add(1, std::memory_order_relaxed);
+        return found ? pos : node.position();
+    }
+
+  private:
+    //! @brief Reads the current snapshot, returning whether it is consistent and for the given time and device.
+    bool read(times_t t, device_t id, vec<n>& pos, bool& found) const {
+        uint64_t seq = m_seq.load(std::memory_order_acquire);
+        if (seq & 1) return false;
+        bool match = m_time.load(std::memory_order_relaxed) == t and m_id.load(std::memory_order_relaxed) == id;
+        found = m_found.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < n; ++i) pos[i] = m_pos[i].load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return m_seq.load(std::memory_order_relaxed) == seq and match;
+    }
+
+    //! @brief Writes a new snapshot (with the mutex held).
+    void write(times_t t, device_t id, vec<n> const& pos, bool found) {
+        m_seq.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        m_time.store(t, std::memory_order_relaxed);
+        m_id.store(id, std::memory_order_relaxed);
+        m_found.store(found, std::memory_order_relaxed);
+        for (size_t i = 0; i < n; ++i) m_pos[i].store(pos[i], std::memory_order_relaxed);
+        m_seq.fetch_add(1, std::memory_order_release);
+    }
+
+    //! @brief The time quantum.
+    times_t m_quantum;
+    //! @brief The sequence counter (odd while writing).
+    std::atomic<uint64_t> m_seq{0};
+    //! @brief The time of the current snapshot.
+    std::atomic<times_t> m_time{-std::numeric_limits<times_t>::infinity()};
+    //! @brief The device of the current snapshot.
+    std::atomic<device_t> m_id{0};
+    //! @brief Whether the device of the current snapshot exists.
+    std::atomic<bool> m_found{false};
+    //! @brief The position of the device of the current snapshot.
+    std::array<std::atomic<real_t>, n> m_pos;
+    //! @brief Mutex serialising the computations.
+    std::mutex m_mutex;
+    //! @brief The number of positions served from a previous computation.
+    std::atomic<size_t> m_hits{0};
+    //! @brief The number of positions computed.
+    std::atomic<size_t> m_misses{0};
+};
+
+
+//! @brief The true position of a device through an oracle, or directly from the network (with the device locked) if no oracle is given.
+template <size_t n, typename node_t>
+vec<n> oracle_position(node_t& node, std::shared_ptr<position_oracle<n>> const& oracle, device_t id) {
+    if (oracle) return oracle->position(node, id);
+    return device_position<n>(node, id, node.current_time());
+}
+
+
+} // namespace fcpp
+
+#endif // FCPP_POSITION_ORACLE_H_
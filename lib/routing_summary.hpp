@@ -0,0 +1,305 @@
+// Copyright © 2026 Giorgio Audrito. All Rights Reserved.
+
+/**
+ * @file routing_summary.hpp
+ * @brief Summaries of sets of devices, to be used as routing information along spanning trees.
+ *
+ * Every summary provides the same interface: a default constructor (empty summary), a constructor
+ * from a single device, `insert`, `merge` and `count` (possibly approximated by excess), equality
+ * and serialisation. The `exact` summary is the reference, whose size grows with the set, while
+ * the other summaries have a size bounded by their template parameters.
+ */
+
+#ifndef FCPP_ROUTING_SUMMARY_H_
+#define FCPP_ROUTING_SUMMARY_H_
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "lib/settings.hpp"
+#include "lib/flat_hash.hpp"
+
+
+/**
+ * @brief Namespace containing all the objects in the FCPP library.
+ */
+namespace fcpp {
+
+
+//! @brief Namespace containing summaries of sets of devices.
+namespace routing {
+
+
+//! @cond INTERNAL
+namespace details {
+    //! @brief Serialises an array of words from/to a given input/output stream.
+    template <typename S, size_t N>
+    S& serialize_words(S& s, std::array<uint64_t, N>& w) {
+        for (uint64_t& x : w) s & x;
+        return s;
+    }
+
+    //! @brief Serialises an array of words from/to a given input/output stream (const overload).
+    template <typename S, size_t N>
+    S& serialize_words(S& s, std::array<uint64_t, N> const& w) {
+        for (uint64_t x : w) s << x;
+        return s;
+    }
+}
+//! @endcond
+
+
+//! @brief Exact summary, holding every device in a hash set.
+class exact : public flat_set<device_t> {
+  public:
+    //! @brief Empty summary.
+    exact() = default;
+
+    //! @brief Summary of a single device.
+    explicit exact(device_t d) : flat_set<device_t>{d} {}
+
+    //! @brief Adds every device in another summary.
+    void merge(exact const& o) {
+        insert(o.begin(), o.end());
+    }
+};
+
+
+/**
+ * @brief Summary as a sorted list of at most `K` intervals of device identifiers.
+ *
+ * Whenever more than `K` intervals would be needed, the two closest intervals are joined,
+ * so that membership is approximated by excess. Works best when devices in a subtree have
+ * close identifiers (as with labels assigned by a visit of the tree).
+ */
+template <size_t K>
+class interval {
+    static_assert(K > 0, "at least one interval is needed");
+
+  public:
+    //! @brief Empty summary.
+    interval() = default;
+
+    //! @brief Summary of a single device.
+    explicit interval(device_t d) : m_lo{d}, m_hi{d} {}
+
+    //! @brief Adds a device to the summary.
+    void insert(device_t d) {
+        add(d, d);
+        shrink();
+    }
+
+    //! @brief Adds every device in another summary.
+    void merge(interval const& o) {
+        for (size_t i = 0; i < o.m_lo.size(); ++i) add(o.m_lo[i], o.m_hi[i]);
+        shrink();
+    }
+
+    //! @brief Whether a device belongs to the summary (0 or 1).
+    size_t count(device_t d) const {
+        size_t i = std::upper_bound(m_lo.begin(), m_lo.end(), d) - m_lo.begin();
+        return i > 0 and d <= m_hi[i-1];
+    }
+
+    //! @brief Equality operator.
+    bool operator==(interval const& o) const {
+        return m_lo == o.m_lo and m_hi == o.m_hi;
+    }
+
+    //! @brief Serialises the content from/to a given input/output stream.
+    template <typename S>
+    S& serialize(S& s) {
+        return s & m_lo & m_hi;
+    }
+
+    //! @brief Serialises the content from/to a given input/output stream (const overload).
+    template <typename S>
+    S& serialize(S& s) const {
+        return s << m_lo << m_hi;
+    }
+
+  private:
+    //! @brief Adds an interval, keeping intervals sorted, disjoint and non-adjacent.
+    void add(device_t lo, device_t hi) {
+        size_t i = std::lower_bound(m_hi.begin(), m_hi.end(), lo) - m_hi.begin();
+        if (i > 0 and m_hi[i-1] + 1 == lo) --i;
+        size_t j = i;
+        while (j < m_lo.size() and m_lo[j] <= hi + 1) ++j;
+        if (i == j) {
+            m_lo.insert(m_lo.begin() + i, lo);
+            m_hi.insert(m_hi.begin() + i, hi);
+            return;
+        }
+        m_lo[i] = std::min(m_lo[i], lo);
+        m_hi[i] = std::max(m_hi[j-1], hi);
+        m_lo.erase(m_lo.begin() + i + 1, m_lo.begin() + j);
+        m_hi.erase(m_hi.begin() + i + 1, m_hi.begin() + j);
+    }
+
+    //! @brief Joins the closest intervals until at most `K` are left.
+    void shrink() {
+        while (m_lo.size() > K) {
+            size_t best = 0;
+            for (size_t i = 1; i+1 < m_lo.size(); ++i)
+                if (m_lo[i+1] - m_hi[i] < m_lo[best+1] - m_hi[best]) best = i;
+            m_hi[best] = m_hi[best+1];
+            m_lo.erase(m_lo.begin() + best + 1);
+            m_hi.erase(m_hi.begin() + best + 1);
+        }
+    }
+
+    //! @brief Lower bounds of the intervals.
+    std::vector<device_t> m_lo;
+    //! @brief Upper bounds of the intervals.
+    std::vector<device_t> m_hi;
+};
+
+
+/**
+ * @brief Summary as a Bloom filter with `W` words of 64 bits and `H` hash functions.
+ *
+ * Membership is approximated by excess, with false positives growing with the number of devices.
+ */
+template <size_t W, size_t H = 3>
+class bloom {
+    static_assert(W > 0 and H > 0, "at least one word and one hash function are needed");
+
+  public:
+    //! @brief Empty summary.
+    bloom() : m_data{} {}
+
+    //! @brief Summary of a single device.
+    explicit bloom(device_t d) : m_data{} {
+        insert(d);
+    }
+
+    //! @brief Adds a device to the summary.
+    void insert(device_t d) {
+        uint64_t h = hash_mix(d);
+        for (size_t i = 0; i < H; ++i) {
+            size_t b = bit(h, i);
+            m_data[b / 64] |= uint64_t(1) << (b % 64);
+        }
+    }
+
+    //! @brief Adds every device in another summary.
+    void merge(bloom const& o) {
+        for (size_t i = 0; i < W; ++i) m_data[i] |= o.m_data[i];
+    }
+
+    //! @brief Whether a device belongs to the summary (0 or 1).
+    size_t count(device_t d) const {
+        uint64_t h = hash_mix(d);
+        for (size_t i = 0; i < H; ++i) {
+            size_t b = bit(h, i);
+            if (((m_data[b / 64] >> (b % 64)) & 1) == 0) return 0;
+        }
+        return 1;
+    }
+
+    //! @brief Equality operator.
+    bool operator==(bloom const& o) const {
+        return m_data == o.m_data;
+    }
+
+    //! @brief Serialises the content from/to a given input/output stream.
+    template <typename S>
+    S& serialize(S& s) {
+        return details::serialize_words(s, m_data);
+    }
+
+    //! @brief Serialises the content from/to a given input/output stream (const overload).
+    template <typename S>
+    S& serialize(S& s) const {
+        return details::serialize_words(s, m_data);
+    }
+
+  private:
+    //! @brief The i-th bit position for a given hash (double hashing).
+    static size_t bit(uint64_t h, size_t i) {
+        return ((h & 0xffffffff) + i * ((h >> 32) | 1)) % (W * 64);
+    }
+
+    //! @brief The bits of the filter.
+    std::array<uint64_t, W> m_data;
+};
+
+
+/**
+ * @brief Summary as a dense bitset of `N` bits.
+ *
+ * Exact when device identifiers are smaller than `N`, otherwise identifiers are folded modulo `N`
+ * and membership is approximated by excess.
+ */
+template <size_t N>
+class bitset {
+    static_assert(N > 0, "at least one bit is needed");
+
+  public:
+    //! @brief Empty summary.
+    bitset() : m_data{} {}
+
+    //! @brief Summary of a single device.
+    explicit bitset(device_t d) : m_data{} {
+        insert(d);
+    }
+
+    //! @brief Adds a device to the summary.
+    void insert(device_t d) {
+        size_t b = d % N;
+        m_data[b / 64] |= uint64_t(1) << (b % 64);
+    }
+
+    //! @brief Adds every device in another summary.
+    void merge(bitset const& o) {
+        for (size_t i = 0; i < words; ++i) m_data[i] |= o.m_data[i];
+    }
+
+    //! @brief Whether a device belongs to the summary (0 or 1).
+    size_t count(device_t d) const {
+        size_t b = d % N;
+        return (m_data[b / 64] >> (b % 64)) & 1;
+    }
+
+    //! @brief Equality operator.
+    bool operator==(bitset const& o) const {
+        return m_data == o.m_data;
+    }
+
+    //! @brief Serialises the content from/to a given input/output stream.
+    template <typename S>
+    S& serialize(S& s) {
+        return details::serialize_words(s, m_data);
+    }
+
+    //! @brief Serialises the content from/to a given input/output stream (const overload).
+    template <typename S>
+    S& serialize(S& s) const {
+        return details::serialize_words(s, m_data);
+    }
+
+  private:
+    //! @brief The number of words needed.
+    static constexpr size_t words = (N + 63) / 64;
+
+    //! @brief The bits of the set.
+    std::array<uint64_t, words> m_data;
+};
+
+
+//! @brief Accumulates a summary into another (for use with collection functions).
+template <typename R>
+R accumulate(R x, R const& y) {
+    x.merge(y);
+    return x;
+}
+
+
+} // namespace routing
+
+
+} // namespace fcpp
+
+#endif // FCPP_ROUTING_SUMMARY_H_
@@ -0,0 +1,251 @@
+// Copyright © 2026 Giorgio Audrito. All Rights Reserved.
+
+/**
+ * @file run_cache.hpp
+ * @brief On-disk cache of the rows logged by batch runs, keyed on their parameters and a build fingerprint.
+ */
+
+#ifndef FCPP_RUN_CACHE_H_
+#define FCPP_RUN_CACHE_H_
+
+#include <dirent.h>
+#include <sys/stat.h>
+#include <utime.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+#include "lib/common/serialize.hpp"
+#include "lib/common/tagged_tuple.hpp"
+#include "lib/component/base.hpp"
+#include "lib/flat_hash.hpp"
+#include "lib/run_recorder.hpp"
+
+
+/**
+ * @brief Namespace containing all the objects in the FCPP library.
+ */
+namespace fcpp {
+
+
+//! @brief Namespace containing tools for batch execution of simulations.
+namespace batch {
+
+
+//! @brief A hash of the running executable (or of its build time, if the executable cannot be read).
+inline std::string executable_hash() {
+    std::ifstream f("/proc/self/exe", std::ios::binary);
+    if (not f) return __DATE__ " " __TIME__;
+    uint64_t h = 0xcbf29ce484222325ULL;
+    std::vector<char> buf(1 << 16);
+    while (f.read(buf.data(), buf.size()) or f.gcount() > 0)
+        for (std::streamsize i = 0; i < f.gcount(); ++i) h = (h ^ uint8_t(buf[i])) * 0x100000001b3ULL;
+    return std::to_string(h);
+}
+
+//! @brief A fingerprint of a build, from a hash of the executable, the names of given types (e.g. the options of the component) and a version string.
+template <typename... Ts>
+std::string build_fingerprint(std::string version) {
+    version += "|" + executable_hash();
+    int dummy[] = {0, (version += std::string("|") + typeid(Ts).name(), 0)...};
+    (void)dummy;
+    return version;
+}
+
+
+/**
+ * @brief Cache of the rows logged by runs for a plotter of type `P`, stored as one file per run in a directory.
+ *
+ * Runs are keyed on a hash of the values of the tags `Ss` in their initialisation tuple together with a
+ * build fingerprint, which should change whenever the simulation changes: `build_fingerprint` covers the
+ * executable, so that any rebuild with a change (to the program, its constants or the library) starts afresh.
+ * Every file also records the type of its rows, and files with rows of a
+ * different type count as missing. Cached runs feed their rows to the plotter without being simulated (see
+ * `run_recorder`). The least recently used files (including temporary files left by interrupted writers) are
+ * removed whenever the directory grows over a given size.
+ */
+template <typename P, typename... Ss>
+class run_cache {
+  public:
+    //! @brief Plotter collecting the rows of a single run, to be used as plot type in the options.
+    using recorder = run_recorder<P>;
+
+    //! @brief Constructor given the cache directory (created if missing), plotter, build fingerprint and maximum size in bytes.
+    run_cache(std::string dir, P& plotter, std::string fingerprint, uint64_t max_size = uint64_t(1) << 30) :
+        m_dir(std::move(dir)), m_plotter(&plotter), m_fingerprint(std::move(fingerprint)), m_max_size(max_size) {
+        mkdir(m_dir.c_str(), 0755);
+        time_t stale = time(nullptr) - 3600;
+        for (auto const& f : files()) {
+            // temporary files untouched for an hour were left by interrupted writers
+            if (f.first.find(".run.tmp") != std::string::npos and f.second.second < stale) std::remove(f.first.c_str());
+            else m_size += f.second.first;
+        }
+    }
+
+    //! @brief The plotter.
+    P& plotter() {
+        return *m_plotter;
+    }
+
+    //! @brief The key of a run given its initialisation tuple.
+    template <typename T>
+    uint64_t key(T const& t) const {
+        common::osstream os;
+        os << m_fingerprint;
+        int dummy[] = {0, (os << common::get<Ss>(t), 0)...};
+        (void)dummy;
+        uint64_t h = 0xcbf29ce484222325ULL;
+        for (char c : os.data()) h = (h ^ uint8_t(c)) * 0x100000001b3ULL;
+        return hash_mix(h);
+    }
+
+    //! @brief Whether a run with a given key is cached with rows of the current type, scheduling its rows to be fed to the plotter if so.
+    bool hit(uint64_t k) {
+        std::string p = path(k);
+        std::ifstream f(p, std::ios::binary);
+        uint64_t count, n;
+        if (not f.read((char*)&count, sizeof(count)) or not f.read((char*)&n, sizeof(n))) return false;
+        std::string const& type = recorder::row_name();
+        if (n != type.size()) return false;
+        std::string name(n, ' ');
+        if (not f.read(&name[0], n) or name != type) return false;
+        utime(p.c_str(), nullptr);
+        m_hits.push_back(k);
+        return true;
+    }
+
+    //! @brief The number of cached runs found.
+    size_t hits() const {
+        return m_hits.size();
+    }
+
+    //! @brief Feeds the rows of cached runs found to the plotter, reading files one at a time.
+    void feed() {
+        for (uint64_t k : m_hits) {
+            std::ifstream f(path(k), std::ios::binary);
+            uint64_t count = 0, n = 0;
+            f.read((char*)&count, sizeof(count));
+            f.read((char*)&n, sizeof(n));
+            f.seekg(n, std::ios::cur);
+            std::vector<char> data((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+            common::isstream is(std::move(data));
+            if (not recorder::replay(*m_plotter, is, count)) return;
+        }
+    }
+
+    //! @brief Stores the rows of a completed run with a given key, evicting old runs if needed.
+    void store(uint64_t k, recorder const& r) {
+        std::vector<char> const& data = r.data();
+        std::string const& type = recorder::row_name();
+        uint64_t count = r.size(), n = type.size();
+        std::string p = path(k);
+        std::string tmp = p + ".tmp" + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+        {
+            std::ofstream f(tmp, std::ios::binary | std::ios::trunc);
+            f.write((char const*)&count, sizeof(count));
+            f.write((char const*)&n, sizeof(n));
+            f.write(type.data(), n);
+            f.write(data.data(), data.size());
+        }
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::rename(tmp.c_str(), p.c_str());
+        m_size += sizeof(count) + sizeof(n) + n + data.size();
+        if (m_size > m_max_size) evict();
+    }
+
+  private:
+    //! @brief The path of the file of a key.
+    std::string path(uint64_t k) const {
+        char s[17];
+        std::snprintf(s, sizeof(s), "%016llx", (unsigned long long)k);
+        return m_dir + "/" + s + ".run";
+    }
+
+    //! @brief The cache files (complete or temporary) with their sizes and last access times.
+    std::vector<std::pair<std::string, std::pair<uint64_t, time_t>>> files() const {
+        std::vector<std::pair<std::string, std::pair<uint64_t, time_t>>> v;
+        if (DIR* d = opendir(m_dir.c_str())) {
+            while (dirent* e = readdir(d)) {
+                std::string n = e->d_name;
+                struct stat s;
+                if (not (n.size() >= 4 and n.substr(n.size() - 4) == ".run") and n.find(".run.tmp") == std::string::npos) continue;
+                if (stat((m_dir + "/" + n).c_str(), &s) == 0) v.emplace_back(m_dir + "/" + n, std::make_pair(uint64_t(s.st_size), s.st_mtime));
+            }
+            closedir(d);
+        }
+        return v;
+    }
+
+    //! @brief Removes the least recently used files until the cache is within half its maximum size.
+    void evict() {
+        auto v = files();
+        std::sort(v.begin(), v.end(), [](auto const& x, auto const& y){
+            return x.second.second < y.second.second;
+        });
+        m_size = 0;
+        for (auto const& f : v) m_size += f.second.first;
+        for (auto const& f : v) {
+            if (m_size <= m_max_size / 2) break;
+            std::remove(f.first.c_str());
+            m_size -= f.second.first;
+        }
+    }
+
+    //! @brief The cache directory.
+    std::string m_dir;
+    //! @brief The plotter.
+    P* m_plotter;
+    //! @brief The build fingerprint.
+    std::string m_fingerprint;
+    //! @brief The maximum size of the cache in bytes.
+    uint64_t m_max_size;
+    //! @brief The current size of the cache in bytes.
+    uint64_t m_size = 0;
+    //! @brief The keys of cached runs to be fed to the plotter.
+    std::vector<uint64_t> m_hits;
+    //! @brief Mutex serialising the cache updates.
+    std::mutex m_mutex;
+};
+
+
+/**
+ * @brief Runs a sequence of simulations, feeding the rows of cached runs to the plotter without simulating them.
+ *
+ * The component type `T` should have `typename run_cache<P, Ss...>::recorder` as plot type, and the sequence should
+ * provide the `plotter` tag (overwritten with a recorder for every run). The rows of cached runs are fed first, and
+ * the other runs are distributed dynamically among a given number of threads.
+ */
+template <typename T, typename S, typename P, typename... Ss>
+void cached_run(T, S const& seq, run_cache<P, Ss...>& cache, size_t threads = std::thread::hardware_concurrency()) {
+    std::vector<size_t> todo;
+    std::vector<uint64_t> keys;
+    for (size_t i = 0; i < seq.size(); ++i) {
+        uint64_t k = cache.key(seq[i]);
+        if (cache.hit(k)) continue;
+        todo.push_back(i);
+        keys.push_back(k);
+    }
+    cache.feed();
+    recorded_run(T{}, seq, todo, cache.plotter(), [&](size_t i, run_recorder<P> const& r){
+        cache.store(keys[i], r);
+    }, threads);
+}
+
+
+} // namespace batch
+
+
+} // namespace fcpp
+
+#endif // FCPP_RUN_CACHE_H_
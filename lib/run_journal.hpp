@@ -0,0 +1,177 @@
+// Copyright © 2026 Giorgio Audrito. All Rights Reserved.
+
+/**
+ * @file run_journal.hpp
+ * @brief Journal of completed batch runs with their logged rows, allowing interrupted batch executions to be resumed.
+ */
+
+#ifndef FCPP_RUN_JOURNAL_H_
+#define FCPP_RUN_JOURNAL_H_
+
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <unistd.h>
+
+#include "lib/common/serialize.hpp"
+#include "lib/common/tagged_tuple.hpp"
+#include "lib/component/base.hpp"
+#include "lib/run_recorder.hpp"
+
+
+/**
+ * @brief Namespace containing all the objects in the FCPP library.
+ */
+namespace fcpp {
+
+
+//! @brief Namespace containing tools for batch execution of simulations.
+namespace batch {
+
+
+/**
+ * @brief Journal of completed runs, recording the rows they logged for a plotter of type `P`.
+ *
+ * Runs are identified by their output file name. Every completed run is appended to the journal file as a
+ * record holding its name and its serialised rows. On resuming, a truncated last record (from an interrupted
+ * execution) is cut from the file before appending new records. Runs with a record and an existing output
+ * file are skipped, and their rows are streamed again from the journal file to the plotter, before any
+ * simulation (see `run_recorder`).
+ */
+template <typename P>
+class run_journal {
+  public:
+    //! @brief Plotter collecting the rows of a single run, to be used as plot type in the options.
+    using recorder = run_recorder<P>;
+
+    //! @brief Constructor given the journal path and plotter, optionally resuming from the records in the path.
+    run_journal(std::string path, P& plotter, bool resume = true) : m_path(std::move(path)), m_plotter(&plotter) {
+        if (resume) load();
+        std::ofstream f(m_path, resume ? std::ios::binary | std::ios::app : std::ios::binary | std::ios::trunc);
+    }
+
+    //! @brief The plotter.
+    P& plotter() {
+        return *m_plotter;
+    }
+
+    //! @brief Whether a run with a given output file completed in a previous execution.
+    bool completed(std::string const& name) const {
+        return m_records.count(name) > 0 and std::ifstream(name).peek() != std::ifstream::traits_type::eof();
+    }
+
+    //! @brief The number of runs completed in previous executions.
+    size_t size() const {
+        return m_records.size();
+    }
+
+    //! @brief Feeds the rows of skipped runs with given output files to the plotter in the given order, reading records back one at a time.
+    void replay(std::vector<std::string> const& names) {
+        std::ifstream f(m_path, std::ios::binary);
+        for (std::string const& name : names) {
+            auto it = m_records.find(name);
+            if (it == m_records.end() or not completed(name)) continue;
+            std::vector<char> data(it->second.size);
+            f.seekg(it->second.offset);
+            f.read(data.data(), data.size());
+            common::isstream is(std::move(data));
+            if (not recorder::replay(*m_plotter, is, it->second.count)) return;
+        }
+    }
+
+    //! @brief Records the rows of a completed run with a given output file.
+    void commit(std::string const& name, recorder const& r) {
+        std::vector<char> const& data = r.data();
+        uint64_t k = name.size(), c = r.size(), d = data.size();
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::ofstream f(m_path, std::ios::binary | std::ios::app);
+        f.write((char const*)&k, sizeof(k));
+        f.write(name.data(), k);
+        f.write((char const*)&c, sizeof(c));
+        f.write((char const*)&d, sizeof(d));
+        f.write(data.data(), d);
+    }
+
+  private:
+    //! @brief The position of a record of a completed run in the journal file.
+    struct record {
+        //! @brief The number of rows.
+        uint64_t count;
+        //! @brief The offset of the serialised rows.
+        std::streamoff offset;
+        //! @brief The size of the serialised rows.
+        uint64_t size;
+    };
+
+    //! @brief Indexes the complete records in the journal file (the latest for every run), cutting a truncated last record.
+    void load() {
+        std::streamoff end, valid = 0;
+        {
+            std::ifstream f(m_path, std::ios::binary | std::ios::ate);
+            if (not f) return;
+            end = f.tellg();
+            f.seekg(0);
+            uint64_t k, c, d;
+            while (f.read((char*)&k, sizeof(k))) {
+                if (std::streamoff(k) > end - f.tellg()) break;
+                std::string name(k, ' ');
+                if (not f.read(&name[0], k) or not f.read((char*)&c, sizeof(c)) or not f.read((char*)&d, sizeof(d))) break;
+                std::streamoff o = f.tellg();
+                if (std::streamoff(d) > end - o) break;
+                m_records[name] = record{c, o, d};
+                valid = o + std::streamoff(d);
+                f.seekg(d, std::ios::cur);
+            }
+        }
+        if (valid < end and truncate(m_path.c_str(), valid) != 0)
+            throw std::runtime_error("cannot truncate journal " + m_path);
+    }
+
+    //! @brief The path of the journal file.
+    std::string m_path;
+    //! @brief The plotter.
+    P* m_plotter;
+    //! @brief The positions of records of runs completed in previous executions.
+    std::unordered_map<std::string, record> m_records;
+    //! @brief Mutex serialising the journal updates.
+    std::mutex m_mutex;
+};
+
+
+/**
+ * @brief Runs a sequence of simulations, skipping the ones completed according to a journal.
+ *
+ * The component type `T` should have `typename run_journal<P>::recorder` as plot type, and the sequence should
+ * provide the `output` and `plotter` tags (the latter is overwritten with a recorder for every run). The rows of
+ * skipped runs are replayed first in the order of the sequence, and the other runs are distributed dynamically
+ * among a given number of threads.
+ */
+template <typename T, typename S, typename P>
+void resumable_run(T, S const& seq, run_journal<P>& journal, size_t threads = std::thread::hardware_concurrency()) {
+    std::vector<size_t> todo;
+    std::vector<std::string> skipped;
+    for (size_t i = 0; i < seq.size(); ++i) {
+        std::string name = common::get<component::tags::output>(seq[i]);
+        if (journal.completed(name)) skipped.push_back(std::move(name));
+        else todo.push_back(i);
+    }
+    journal.replay(skipped);
+    recorded_run(T{}, seq, todo, journal.plotter(), [&](size_t i, run_recorder<P> const& r){
+        journal.commit(common::get<component::tags::output>(seq[todo[i]]), r);
+    }, threads);
+}
+
+
+} // namespace batch
+
+
+} // namespace fcpp
+
+#endif // FCPP_RUN_JOURNAL_H_
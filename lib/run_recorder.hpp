@@ -0,0 +1,161 @@
+// Copyright © 2026 Giorgio Audrito. All Rights Reserved.
+
+/**
+ * @file run_recorder.hpp
+ * @brief Recording of the rows logged by batch runs, for storing them and feeding them again to a plotter later.
+ */
+
+#ifndef FCPP_RUN_RECORDER_H_
+#define FCPP_RUN_RECORDER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <typeinfo>
+#include <vector>
+
+#include "lib/common/serialize.hpp"
+#include "lib/common/tagged_tuple.hpp"
+#include "lib/component/base.hpp"
+
+
+/**
+ * @brief Namespace containing all the objects in the FCPP library.
+ */
+namespace fcpp {
+
+
+//! @brief Namespace containing tools for batch execution of simulations.
+namespace batch {
+
+
+/**
+ * @brief Plotter recording the rows of a single run while forwarding them to a plotter of type `P`, to be used as plot type in the options.
+ *
+ * The type of rows is registered at static initialisation by the component logging to the recorder, so that
+ * recorded rows can be fed again to a plotter before any simulation runs. Components logging rows of different
+ * types to recorders of the same plotter type are not supported.
+ */
+template <typename P>
+class run_recorder {
+  public:
+    //! @brief Constructor given the plotter.
+    explicit run_recorder(P& plotter) : m_plotter(&plotter) {}
+
+    //! @brief Processes a logged row.
+    template <typename R>
+    run_recorder& operator<<(R const& row) {
+        static_cast<void>(&row_type<R>::registered);
+        *m_plotter << row;
+        m_rows << row;
+        ++m_count;
+        return *this;
+    }
+
+    //! @brief The number of rows recorded.
+    uint64_t size() const {
+        return m_count;
+    }
+
+    //! @brief The rows recorded, serialised.
+    std::vector<char> const& data() const {
+        return m_rows.data();
+    }
+
+    //! @brief A name of the registered type of rows, with its size (empty if no type was registered).
+    static std::string const& row_name() {
+        return registry().name;
+    }
+
+    //! @brief Feeds a number of serialised rows of the registered type to a plotter, returning whether a type was registered.
+    static bool replay(P& plotter, common::isstream& is, uint64_t count) {
+        if (not registry().replay) return false;
+        registry().replay(plotter, is, count);
+        return true;
+    }
+
+  private:
+    //! @brief The registered type of rows.
+    struct entry {
+        //! @brief Function feeding serialised rows to a plotter.
+        void (*replay)(P&, common::isstream&, uint64_t) = nullptr;
+        //! @brief The name of the type.
+        std::string name;
+    };
+
+    //! @brief Registers the type of rows logged, at static initialisation.
+    template <typename R>
+    struct row_type {
+        //! @brief Whether the type has been registered.
+        static bool const registered;
+    };
+
+    //! @brief The registered type of rows.
+    static entry& registry() {
+        static entry e;
+        return e;
+    }
+
+    //! @brief Registers a type of rows.
+    template <typename R>
+    static bool enroll() {
+        registry().replay = [](P& plotter, common::isstream& is, uint64_t count){
+            for (uint64_t i = 0; i < count; ++i) {
+                R row;
+                is >> row;
+                plotter << row;
+            }
+        };
+        registry().name = std::string(typeid(R).name()) + "/" + std::to_string(sizeof(R));
+        return true;
+    }
+
+    //! @brief The plotter.
+    P* m_plotter;
+    //! @brief The number of rows recorded.
+    uint64_t m_count = 0;
+    //! @brief The rows recorded.
+    common::osstream m_rows;
+};
+
+template <typename P>
+template <typename R>
+bool const run_recorder<P>::row_type<R>::registered = run_recorder<P>::template enroll<R>();
+
+
+/**
+ * @brief Runs the simulations at given indices of a sequence, each with its own recorder as plotter.
+ *
+ * The component type `T` should have `run_recorder<P>` as plot type, and the sequence should provide the `plotter`
+ * tag (overwritten with the recorder of every run). Runs are distributed dynamically among a given number of
+ * threads, and a given function is called with the position in the indices and the recorder of every completed run.
+ */
+template <typename T, typename S, typename P, typename F>
+void recorded_run(T, S const& seq, std::vector<size_t> const& todo, P& plotter, F&& done, size_t threads) {
+    std::atomic<size_t> next{0};
+    auto worker = [&](){
+        for (size_t i = next++; i < todo.size(); i = next++) {
+            auto t = seq[todo[i]];
+            run_recorder<P> r(plotter);
+            common::get<component::tags::plotter>(t) = &r;
+            {
+                typename T::net network{t};
+                network.run();
+            }
+            done(i, r);
+        }
+    };
+    std::vector<std::thread> pool;
+    for (size_t i = 1; i < threads; ++i) pool.emplace_back(worker);
+    worker();
+    for (std::thread& t : pool) t.join();
+}
+
+
+} // namespace batch
+
+
+} // namespace fcpp
+
+#endif // FCPP_RUN_RECORDER_H_
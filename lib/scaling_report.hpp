@@ -0,0 +1,288 @@
+// Copyright © 2026 Giorgio Audrito. All Rights Reserved.
+
+/**
+ * @file scaling_report.hpp
+ * @brief Machine-readable report of the timings of batch executions under different strategies, in JSON and CSV.
+ */
+
+#ifndef FCPP_SCALING_REPORT_H_
+#define FCPP_SCALING_REPORT_H_
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <map>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifdef FCPP_MPI
+#include <mpi.h>
+#endif
+
+
+/**
+ * @brief Namespace containing all the objects in the FCPP library.
+ */
+namespace fcpp {
+
+
+//! @brief Namespace containing tools for batch execution of simulations.
+namespace batch {
+
+
+//! @brief Gathers a value from every MPI process, returning them by rank in process 0 (the value itself without MPI).
+inline std::vector<double> mpi_gather(double x) {
+#ifdef FCPP_MPI
+    int rank, n_procs;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &n_procs);
+    std::vector<double> v(rank == 0 ? n_procs : 0);
+    MPI_Gather(&x, 1, MPI_DOUBLE, v.data(), 1, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    return v;
+#else
+    return {x};
+#endif
+}
+
+
+/**
+ * @brief Report of the timings of batch executions, repeated under different strategies.
+ *
+ * Strategies are grouped in sections, given by a scaling experiment (weak or strong) and a process layout. For every
+ * strategy, the report holds the mean, standard deviation and minimum of the times of the repetitions, and of their
+ * tail latencies if given. It also holds the busy time of every process (the time until its own runs completed) and
+ * its idle time (the rest of the execution, including the wait for other processes and the merge of results),
+ * averaged over repetitions, and the load-imbalance ratio between the maximum and mean busy time. Speedup is computed
+ * against the fastest strategy of the same section in a single-process execution, which is either in the same report
+ * or loaded from its CSV output. Parallel efficiency divides the speedup by the ratio between the threads in use
+ * (over every process) and the threads of the single-process execution.
+ */
+class scaling_report {
+  public:
+    //! @brief Constructor given the number of nodes and processes.
+    scaling_report(size_t nodes, size_t procs) : m_nodes(nodes), m_procs(procs) {}
+
+    //! @brief Starts a section, given the scaling experiment, whether it is weak scaling, the layout and threads per process.
+    void section(std::string scaling, bool weak, std::string layout, size_t threads) {
+        m_scaling = std::move(scaling);
+        m_weak = weak;
+        m_layout = std::move(layout);
+        m_threads = threads;
+    }
+
+    //! @brief The layout of the current section.
+    std::string const& layout() const {
+        return m_layout;
+    }
+
+    //! @brief Adds a strategy given its times, tail latencies (possibly not-a-number) and busy times by rank of every repetition.
+    void add(std::string strategy, std::vector<double> times, std::vector<double> tails, std::vector<std::vector<double>> busy) {
+        m_entries.push_back({m_scaling, m_weak, m_layout, std::move(strategy), m_threads, std::move(times), std::move(tails), std::move(busy)});
+    }
+
+    /**
+     * @brief Loads the reference times from the CSV report of a single-process execution.
+     *
+     * Returns whether the file could be read.
+     */
+    bool load_baselines(std::string const& path) {
+        std::ifstream f(path);
+        std::string line;
+        if (not std::getline(f, line)) return false;
+        std::vector<std::string> header = split(line);
+        auto column = [&](std::string const& s) {
+            return size_t(std::find(header.begin(), header.end(), s) - header.begin());
+        };
+        size_t cs = column("scaling"), cl = column("layout"), cp = column("procs"), ct = column("threads"), cm = column("mean");
+        while (std::getline(f, line)) {
+            std::vector<std::string> row = split(line);
+            if (std::max({cs, cl, cp, ct, cm}) >= row.size() or row[cp] != "1" or row[cm].empty()) continue;
+            double t = std::stod(row[cm]);
+            auto k = std::make_pair(row[cs], row[cl]);
+            if (m_baselines.count(k) == 0 or t < m_baselines[k].first) m_baselines[k] = {t, std::stoul(row[ct])};
+        }
+        return true;
+    }
+
+    //! @brief Writes the report in JSON format.
+    void write_json(std::ostream& o) const {
+        o << "{\n  \"nodes\": " << m_nodes << ",\n  \"procs\": " << m_procs << ",\n  \"strategies\": [";
+        bool first = true;
+        for (entry const& e : m_entries) {
+            summary s = summarise(e);
+            o << (first ? "\n" : ",\n") << "    {";
+            o << "\"scaling\": \"" << e.scaling << "\", \"layout\": \"" << e.layout << "\", \"strategy\": \"" << e.strategy << "\", ";
+            o << "\"threads\": " << e.threads << ", \"runs\": " << e.times.size() << ", ";
+            o << "\"mean\": " << number(s.mean) << ", \"stddev\": " << number(s.stddev) << ", \"min\": " << number(s.min) << ", ";
+            o << "\"tail_mean\": " << number(s.tail_mean) << ", \"tail_min\": " << number(s.tail_min) << ", ";
+            o << "\"busy\": " << numbers(s.busy) << ", \"idle\": " << numbers(s.idle) << ", ";
+            o << "\"imbalance\": " << number(s.imbalance) << ", \"speedup\": " << number(s.speedup) << ", \"efficiency\": " << number(s.efficiency) << "}";
+            first = false;
+        }
+        o << "\n  ]\n}\n";
+    }
+
+    //! @brief Writes the report in CSV format (busy and idle times summarised by their mean and maximum over ranks).
+    void write_csv(std::ostream& o) const {
+        o << "scaling,layout,strategy,nodes,procs,threads,runs,mean,stddev,min,tail_mean,tail_min,busy_mean,busy_max,idle_mean,idle_max,imbalance,speedup,efficiency\n";
+        for (entry const& e : m_entries) {
+            summary s = summarise(e);
+            o << e.scaling << "," << e.layout << "," << e.strategy << "," << m_nodes << "," << m_procs << "," << e.threads << "," << e.times.size() << ",";
+            o << number(s.mean, "") << "," << number(s.stddev, "") << "," << number(s.min, "") << "," << number(s.tail_mean, "") << "," << number(s.tail_min, "") << ",";
+            o << number(mean(s.busy), "") << "," << number(max(s.busy), "") << "," << number(mean(s.idle), "") << "," << number(max(s.idle), "") << ",";
+            o << number(s.imbalance, "") << "," << number(s.speedup, "") << "," << number(s.efficiency, "") << "\n";
+        }
+    }
+
+    //! @brief Writes the report in JSON and CSV format, to files with a given path and extensions "json" and "csv".
+    bool write(std::string const& path) const {
+        std::ofstream j(path + ".json"), c(path + ".csv");
+        write_json(j);
+        write_csv(c);
+        return j.good() and c.good();
+    }
+
+  private:
+    //! @brief The timings of a strategy.
+    struct entry {
+        //! @brief The scaling experiment.
+        std::string scaling;
+        //! @brief Whether the scaling experiment is weak scaling.
+        bool weak;
+        //! @brief The layout.
+        std::string layout;
+        //! @brief The strategy.
+        std::string strategy;
+        //! @brief The number of threads per process.
+        size_t threads;
+        //! @brief The times of the repetitions.
+        std::vector<double> times;
+        //! @brief The tail latencies of the repetitions.
+        std::vector<double> tails;
+        //! @brief The busy times by rank of the repetitions.
+        std::vector<std::vector<double>> busy;
+    };
+
+    //! @brief The statistics of a strategy.
+    struct summary {
+        //! @brief Statistics of the times.
+        double mean, stddev, min;
+        //! @brief Statistics of the tail latencies.
+        double tail_mean, tail_min;
+        //! @brief The mean busy and idle times by rank.
+        std::vector<double> busy, idle;
+        //! @brief The load-imbalance ratio.
+        double imbalance;
+        //! @brief The speedup and parallel efficiency.
+        double speedup, efficiency;
+    };
+
+    //! @brief The mean of some values.
+    static double mean(std::vector<double> const& v) {
+        double s = 0;
+        for (double x : v) s += x;
+        return v.empty() ? NAN : s / v.size();
+    }
+
+    //! @brief The maximum of some values.
+    static double max(std::vector<double> const& v) {
+        return v.empty() ? NAN : *std::max_element(v.begin(), v.end());
+    }
+
+    //! @brief The minimum of some values.
+    static double min(std::vector<double> const& v) {
+        return v.empty() ? NAN : *std::min_element(v.begin(), v.end());
+    }
+
+    //! @brief Prints a number (or a given placeholder if not finite).
+    static std::string number(double x, char const* missing = "null") {
+        if (not std::isfinite(x)) return missing;
+        std::stringstream s;
+        s.precision(6);
+        s << x;
+        return s.str();
+    }
+
+    //! @brief Prints a list of numbers in JSON format.
+    static std::string numbers(std::vector<double> const& v) {
+        std::string s = "[";
+        for (size_t i = 0; i < v.size(); ++i) s += (i ? ", " : "") + number(v[i]);
+        return s + "]";
+    }
+
+    //! @brief Splits a CSV line.
+    static std::vector<std::string> split(std::string const& line) {
+        std::vector<std::string> v;
+        std::stringstream ss(line);
+        std::string x;
+        while (std::getline(ss, x, ',')) v.push_back(x);
+        return v;
+    }
+
+    //! @brief The reference time of the section of a strategy, with the threads it used.
+    std::pair<double, size_t> reference(entry const& e) const {
+        auto k = std::make_pair(e.scaling, e.layout);
+        if (m_baselines.count(k)) return m_baselines.at(k);
+        if (m_procs > 1) return {NAN, 0};
+        std::pair<double, size_t> r = {INFINITY, e.threads};
+        for (entry const& x : m_entries)
+            if (x.scaling == e.scaling and x.layout == e.layout and mean(x.times) < r.first) r = {mean(x.times), x.threads};
+        return r;
+    }
+
+    //! @brief Computes the statistics of a strategy.
+    summary summarise(entry const& e) const {
+        summary s;
+        s.mean = mean(e.times);
+        s.min = min(e.times);
+        double d = 0;
+        for (double x : e.times) d += (x - s.mean) * (x - s.mean);
+        s.stddev = e.times.size() > 1 ? std::sqrt(d / (e.times.size() - 1)) : NAN;
+        std::vector<double> tails;
+        for (double x : e.tails) if (not std::isnan(x)) tails.push_back(x);
+        s.tail_mean = mean(tails);
+        s.tail_min = min(tails);
+        size_t ranks = e.busy.empty() ? 0 : e.busy[0].size();
+        s.busy.assign(ranks, 0);
+        s.idle.assign(ranks, 0);
+        for (size_t i = 0; i < e.busy.size(); ++i) {
+            for (size_t r = 0; r < ranks; ++r) {
+                s.busy[r] += e.busy[i][r] / e.busy.size();
+                s.idle[r] += std::max(e.times[i] - e.busy[i][r], 0.0) / e.busy.size();
+            }
+        }
+        s.imbalance = max(s.busy) / mean(s.busy);
+        std::pair<double, size_t> t = reference(e);
+        s.speedup = (e.weak ? m_nodes : 1) * t.first / s.mean;
+        s.efficiency = s.speedup * t.second / (m_procs * e.threads);
+        return s;
+    }
+
+    //! @brief The number of nodes.
+    size_t m_nodes;
+    //! @brief The number of processes.
+    size_t m_procs;
+    //! @brief The scaling experiment of the current section.
+    std::string m_scaling;
+    //! @brief Whether the current section is weak scaling.
+    bool m_weak = false;
+    //! @brief The layout of the current section.
+    std::string m_layout;
+    //! @brief The number of threads per process of the current section.
+    size_t m_threads = 0;
+    //! @brief The strategies added.
+    std::vector<entry> m_entries;
+    //! @brief The reference times loaded with their threads, by scaling experiment and layout.
+    std::map<std::pair<std::string, std::string>, std::pair<double, size_t>> m_baselines;
+};
+
+
+} // namespace batch
+
+
+} // namespace fcpp
+
+#endif // FCPP_SCALING_REPORT_H_
@@ -0,0 +1,177 @@
+// Copyright © 2026 Giorgio Audrito. All Rights Reserved.
+
+/**
+ * @file silent_export.hpp
+ * @brief Sharing of values with neighbours through "silent rounds", sending an unchanged value as its epoch only.
+ *
+ * A device sends its value in full when it changes, and otherwise a short token carrying the epoch of the last
+ * change. Receivers reuse their copy of the value sent in full, which is dropped with the messages of the sender
+ * when they expire (according to the `retain` metric). Copies of the values of neighbours are kept through `old`,
+ * so `export_split<true>` is needed for them not to be sent to neighbours.
+ */
+
+#ifndef FCPP_SILENT_EXPORT_H_
+#define FCPP_SILENT_EXPORT_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "lib/beautify.hpp"
+#include "lib/coordination.hpp"
+
+
+/**
+ * @brief Namespace containing all the objects in the FCPP library.
+ */
+namespace fcpp {
+
+
+//! @brief Value shared with neighbours: the epoch of the value, the value itself if sent in full, and whether some value of neighbours is missing.
+template <typename T>
+struct silent_payload {
+    //! @brief The epoch of the last change of the value (zero for no value).
+    uint32_t epoch = 0;
+    //! @brief Whether the value is sent in full.
+    bool full = false;
+    //! @brief Whether the sender misses the current value of some neighbour (so that neighbours send it in full).
+    bool missing = false;
+    //! @brief The value (meaningful only if sent in full).
+    T value;
+
+    //! @brief Serialises the content from/to a given input/output stream (the value only if sent in full).
+    template <typename S>
+    S& serialize(S& s) {
+        s & epoch & full & missing;
+        if (full) s & value;
+        return s;
+    }
+
+    //! @brief Serialises the content from/to a given input/output stream (the value only if sent in full, const overload).
+    template <typename S>
+    S& serialize(S& s) const {
+        s << epoch << full << missing;
+        if (full) s << value;
+        return s;
+    }
+};
+
+
+//! @brief Local state of a sharing through silent rounds: own value and copies of neighbours' values.
+template <typename T>
+struct silent_state {
+    //! @brief The epoch of the last change of the own value.
+    uint32_t epoch = 0;
+    //! @brief The own value.
+    T value;
+    //! @brief Neighbours whose values are held (sorted).
+    std::vector<device_t> ids;
+    //! @brief Epochs of neighbours' values held.
+    std::vector<uint32_t> epochs;
+    //! @brief Neighbours' values held.
+    std::vector<T> values;
+
+    //! @brief Serialises the content from/to a given input/output stream.
+    template <typename S>
+    S& serialize(S& s) {
+        return s & epoch & value & ids & epochs & values;
+    }
+
+    //! @brief Serialises the content from/to a given input/output stream (const overload).
+    template <typename S>
+    S& serialize(S& s) const {
+        return s << epoch << value << ids << epochs << values;
+    }
+};
+
+
+//! @brief Namespace containing the libraries of coordination routines.
+namespace coordination {
+
+
+/**
+ * @brief Shares a value with neighbours (as `nbr(CALL, init, f)`) through silent rounds.
+ *
+ * The function `f` receives the field of values of neighbours (`init` for neighbours whose value was never
+ * received), and its result is shared with neighbours and returned. The value is sent in full when it changes,
+ * when a new neighbour appears, and when some neighbour reports to miss a value; otherwise only its epoch is sent.
+ * A receiver missing the current value of a neighbour (as after a message lost between two of its rounds) keeps
+ * using its older copy for that round.
+ */
+template <typename node_t, typename T, typename F>
+T silent_nbr(ARGS, T const& init, F&& f) { CODE
+    using state_t = silent_state<T>;
+    using payload_t = silent_payload<T>;
+    T result;
+    old(CALL, state_t{}, [&](state_t s){
+        nbr(CALL, payload_t{}, [&](field<payload_t> const& p){
+            state_t t;
+            bool missing = false, resend = false;
+            // updates the copies of neighbours' values
+            map_hood([&](payload_t const& x, device_t id){
+                if (id == node.uid) return 0;
+                auto it = std::lower_bound(s.ids.begin(), s.ids.end(), id);
+                size_t i = it - s.ids.begin();
+                bool held = it != s.ids.end() and *it == id;
+                // a neighbour missing some value, or not heard before, needs the own value in full
+                resend = resend or x.missing or not held;
+                if (x.epoch == 0) return 0;
+                if (x.full) {
+                    t.ids.push_back(id);
+                    t.epochs.push_back(x.epoch);
+                    t.values.push_back(x.value);
+                } else if (held) {
+                    missing = missing or s.epochs[i] != x.epoch;
+                    t.ids.push_back(id);
+                    t.epochs.push_back(s.epochs[i]);
+                    t.values.push_back(std::move(s.values[i]));
+                } else missing = true;
+                return 0;
+            }, p, node.nbr_uid());
+            std::vector<size_t> order(t.ids.size());
+            for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+            std::sort(order.begin(), order.end(), [&](size_t i, size_t j){
+                return t.ids[i] < t.ids[j];
+            });
+            s.ids.clear();
+            s.epochs.clear();
+            s.values.clear();
+            for (size_t i : order) {
+                s.ids.push_back(t.ids[i]);
+                s.epochs.push_back(t.epochs[i]);
+                s.values.push_back(std::move(t.values[i]));
+            }
+            // computes the new value from the field of neighbours' values
+            result = f(map_hood([&](device_t id){
+                if (id == node.uid) return s.epoch > 0 ? s.value : init;
+                auto it = std::lower_bound(s.ids.begin(), s.ids.end(), id);
+                return it != s.ids.end() and *it == id ? s.values[it - s.ids.begin()] : init;
+            }, node.nbr_uid()));
+            // builds the payload, with the value in full only if it changed or some neighbour needs it
+            payload_t q;
+            if (s.epoch == 0 or not (result == s.value)) {
+                ++s.epoch;
+                s.value = result;
+                resend = true;
+            }
+            q.epoch = s.epoch;
+            q.full = resend;
+            q.missing = missing;
+            if (resend) q.value = s.value;
+            return q;
+        });
+        return s;
+    });
+    return result;
+}
+//! @brief Export list for silent_nbr.
+template <typename T>
+using silent_nbr_t = common::export_list<silent_state<T>, silent_payload<T>>;
+
+
+} // namespace coordination
+
+
+} // namespace fcpp
+
+#endif // FCPP_SILENT_EXPORT_H_
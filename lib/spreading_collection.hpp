@@ -10,7 +10,12 @@
 #ifndef FCPP_SPREADING_COLLECTION_H_
 #define FCPP_SPREADING_COLLECTION_H_
 
+#include <memory>
+
 #include "lib/fcpp.hpp"
+#include "lib/position_oracle.hpp"
+#include "lib/run_journal.hpp"
+#include "lib/silent_export.hpp"
 
 
 /**
@@ -49,6 +54,8 @@ namespace tags {
     struct side {};
     //! @brief The factor producing hues from distances.
     struct hue_scale {};
+    //! @brief Oracle of true source positions (shared by the network).
+    struct oracle {};
 
     //! @brief True distance of the current node from the source.
     struct true_distance {};
@@ -68,6 +75,10 @@ namespace tags {
     struct node_size {};
     //! @brief Shape of the current node.
     struct node_shape {};
+    //! @brief Number of rounds performed by the current node.
+    struct round_count {};
+    //! @brief Total size of messages sent by the current node.
+    struct msg_bytes {};
 }
 
 
@@ -76,10 +87,8 @@ FUN bool select_source(ARGS, int step) { CODE
     // the source ID increases by 1 every "step" seconds
     device_t source_id = ((int)node.current_time()) / step;
     bool is_source = node.uid == source_id;
-    // retrieves from the net object the current true position of the source
-    vec<3> source_pos = node.position();
-    if (node.net.node_count(source_id))
-        source_pos = node.net.node_at(source_id).position(node.current_time());
+    // retrieves the true position of the source, computed once per time unit by the shared oracle
+    vec<3> source_pos = oracle_position(node, node.storage(tags::oracle{}), source_id);
     // store relevant values in the node storage
     node.storage(tags::true_distance{})     = distance(node.position(), source_pos);
     node.storage(tags::node_size{})         = is_source ? 20 : 10;
@@ -90,8 +99,100 @@ FUN bool select_source(ARGS, int step) { CODE
 FUN_EXPORT select_source_t = common::export_list<>;
 
 
-//! @brief Main function.
-MAIN() {
+//! @brief Maximum between finite values (non-finite values are treated as zero).
+inline double finite_max(double x, double y) {
+    x = isfinite(x) ? x : 0;
+    y = isfinite(y) ? y : 0;
+    return max(x, y);
+}
+
+/**
+ * @brief Computes the distance from a source, the maximum finite distance (diameter) collected in the source
+ * and the diameter broadcast to the whole network, as a tuple.
+ *
+ * Composes `abf_distance`, `mp_collection` and `broadcast`, each with its own neighbour exchange.
+ */
+FUN tuple<double, double, double> diameter_estimate(ARGS, bool is_source, std::false_type) { CODE
+    // calculate distances from the source
+    double dist = abf_distance(CALL, is_source);
+    // collect the maximum finite distance (diameter) back towards the source
+    double sdiam = mp_collection(CALL, dist, dist, 0.0, finite_max, [](double x, int){
+        return x;
+    });
+    // broadcast the diameter computed in the source to the whole network
+    double diam = broadcast(CALL, dist, sdiam);
+    return make_tuple(dist, sdiam, diam);
+}
+
+//! @brief Computes the distance, the diameter in the source and the broadcast diameter from the values of neighbours, packed together.
+FUN tuple<double, double, double> diameter_step(ARGS, bool is_source, field<tuple<double, double, double>> const& x) { CODE
+    field<double> nbrdist = get<0>(x);
+    // calculate distances from the source (as abf_distance)
+    double dist = min_hood(CALL, nbrdist + node.nbr_dist(), is_source ? 0.0 : INF);
+    // collect the maximum finite distance from neighbours further away (as mp_collection)
+    double sdiam = fold_hood(CALL, finite_max, mux(nbrdist > dist, get<1>(x), 0.0), dist);
+    // take the diameter from the neighbour closest to the source (as broadcast)
+    double diam = get<1>(min_hood(CALL, make_tuple(nbrdist, get<2>(x)), make_tuple(dist, sdiam)));
+    return make_tuple(dist, sdiam, diam);
+}
+
+/**
+ * @brief Computes the distance from a source, the maximum finite distance (diameter) collected in the source
+ * and the diameter broadcast to the whole network, as a tuple.
+ *
+ * Produces the same values as the composition of `abf_distance`, `mp_collection` and `broadcast`,
+ * through a single neighbour exchange of the three values packed together.
+ */
+FUN tuple<double, double, double> diameter_estimate(ARGS, bool is_source, std::true_type) { CODE
+    tuple<double, double, double> r;
+    nbr(CALL, make_tuple(INF, 0.0, 0.0), [&](field<tuple<double, double, double>> x){
+        r = diameter_step(CALL, is_source, x);
+        return r;
+    });
+    return r;
+}
+
+//! @brief Tag selecting a single neighbour exchange through silent rounds.
+struct silent_exchange {};
+
+/**
+ * @brief Computes the distance from a source, the maximum finite distance (diameter) collected in the source
+ * and the diameter broadcast to the whole network, as a tuple.
+ *
+ * Produces the same values as the fused exchange, sending the three values in full only when they change
+ * (or a neighbour needs them) through `silent_nbr`.
+ */
+FUN tuple<double, double, double> diameter_estimate(ARGS, bool is_source, silent_exchange) { CODE
+    return silent_nbr(CALL, make_tuple(INF, 0.0, 0.0), [&](field<tuple<double, double, double>> const& x){
+        return diameter_step(CALL, is_source, x);
+    });
+}
+
+//! @brief Export types used by the diameter_estimate function (fused or not, through silent rounds or not).
+template <bool fused, bool silent = false>
+using diameter_estimate_t = std::conditional_t<silent,
+    common::export_list<silent_nbr_t<tuple<double, double, double>>>,
+    std::conditional_t<fused,
+        common::export_list<tuple<double, double, double>>,
+        common::export_list<abf_distance_t, mp_collection_t<double, double>, broadcast_t<double, double>>
+    >
+>;
+
+
+//! @brief Main function, with fused or unfused neighbour exchanges, through silent rounds or not.
+template <bool fused, bool silent = false>
+struct diameter_main {
+    //! @brief Executes a round on a node.
+    template <typename node_t>
+    void operator()(node_t& node, times_t);
+};
+
+//! @brief Main function (with unfused neighbour exchanges).
+using main = diameter_main<false>;
+
+template <bool fused, bool silent>
+template <typename node_t>
+void diameter_main<fused, silent>::operator()(node_t& node, times_t) {
     // access stored constants
     double const& side      = node.storage(tags::side{});
     double const& speed     = node.storage(tags::speed{});
@@ -100,18 +201,9 @@ MAIN() {
     rectangle_walk(CALL, make_vec(0,0,0), make_vec(side,side,height), speed, 1);
     // selects a different source every 50 simulated seconds
     bool is_source = select_source(CALL, 50);
-    // calculate distances from the source
-    double dist = abf_distance(CALL, is_source);
-    // collect the maximum finite distance (diameter) back towards the source
-    double sdiam = mp_collection(CALL, dist, dist, 0.0, [](double x, double y){
-        x = isfinite(x) ? x : 0;
-        y = isfinite(y) ? y : 0;
-        return max(x, y);
-    }, [](double x, int){
-        return x;
-    });
-    // broadcast the diameter computed in the source to the whole network
-    double diam = broadcast(CALL, dist, sdiam);
+    // calculate distances, diameter in the source and diameter broadcast to the network
+    tuple<double, double, double> d = diameter_estimate(CALL, is_source, std::conditional_t<silent, silent_exchange, std::integral_constant<bool, fused>>{});
+    double dist = get<0>(d), sdiam = get<1>(d), diam = get<2>(d);
     // store relevant values in the node storage
     node.storage(tags::calc_distance{})     = dist;
     node.storage(tags::source_diameter{})   = sdiam;
@@ -120,9 +212,15 @@ MAIN() {
     node.storage(tags::distance_c{})        = color::hsva(dist *hue_scale, 1, 1);
     node.storage(tags::source_diameter_c{}) = color::hsva(sdiam*hue_scale, 1, 1);
     node.storage(tags::diameter_c{})        = color::hsva(diam *hue_scale, 1, 1);
+    // store round and message size counters
+    node.storage(tags::round_count{})       += 1;
+    node.storage(tags::msg_bytes{})         += node.msg_size();
 }
-//! @brief Export types used by the main function.
-FUN_EXPORT main_t = common::export_list<rectangle_walk_t<3>, select_source_t, abf_distance_t, mp_collection_t<double, double>, broadcast_t<double, double>>;
+//! @brief Export types used by the main function (fused or not, through silent rounds or not).
+template <bool fused, bool silent = false>
+using diameter_main_t = common::export_list<rectangle_walk_t<3>, select_source_t, diameter_estimate_t<fused, silent>>;
+//! @brief Export types used by the main function (with unfused neighbour exchanges).
+FUN_EXPORT main_t = diameter_main_t<false>;
 
 
 } // namespace coordination
@@ -170,6 +268,8 @@ using hue_d  = functor::div<
     distribution::constant_n<double, 360>,
     functor::add<distribution::constant_i<double, side>, distribution::constant_n<double, height>>
 >;
+//! @brief The distribution of oracles (all sharing the globally provided one).
+using oracle_d = distribution::constant_i<std::shared_ptr<position_oracle<dim>>, oracle>;
 //! @brief The distribution of node speeds (all equal to a fixed value).
 using speed_d = functor::mul<
     distribution::constant_i<double, speed>,
@@ -179,6 +279,7 @@ using speed_d = functor::mul<
 using store_t = tuple_store<
     side,               double,
     hue_scale,          double,
+    oracle,             std::shared_ptr<position_oracle<dim>>,
     speed,              double,
     true_distance,      double,
     calc_distance,      double,
@@ -188,7 +289,9 @@ using store_t = tuple_store<
     source_diameter_c,  color,
     diameter_c,         color,
     node_shape,         shape,
-    node_size,          double
+    node_size,          double,
+    round_count,        size_t,
+    msg_bytes,          size_t
 >;
 //! @brief The tags and corresponding aggregators to be logged.
 using aggregator_t = aggregators<
@@ -217,12 +320,15 @@ using speed_plot_t = plot::split<speed, plot::filter<plot::time, filter::above<5
 using plot_t = plot::join<time_plot_t, tvar_plot_t, dens_plot_t, hops_plot_t, speed_plot_t>;
 
 
-//! @brief The general simulation options.
+//! @brief The general simulation options, with fused or unfused neighbour exchanges, emulated message sizes or not, multithreading on node rounds or not, a given plot type, and silent rounds or not.
+template <bool fused = false, bool sized = false, bool threaded = false, typename P = plot_t, bool silent = false>
 DECLARE_OPTIONS(list,
-    parallel<false>,     // no multithreading on node rounds
+    parallel<threaded>,  // whether to use multithreading on node rounds
     synchronised<false>, // optimise for asynchronous networks
-    program<coordination::main>,   // program to be run (refers to MAIN above)
-    exports<coordination::main_t>, // export type list (types used in messages)
+    message_size<sized>, // whether message sizes are emulated
+    export_split<true>,  // values kept by old are not sent to neighbours
+    program<coordination::diameter_main<fused, silent>>,   // program to be run (refers to diameter_main above)
+    exports<coordination::diameter_main_t<fused, silent>>, // export type list (types used in messages)
     round_schedule<round_s>, // the sequence generator for round events on nodes
     log_schedule<log_s>,     // the sequence generator for log events on the network
     spawn_schedule<spawn_s>, // the sequence generator of node creation events on the network
@@ -232,6 +338,7 @@ DECLARE_OPTIONS(list,
         x,          rectangle_d, // initialise position randomly in a rectangle for new nodes
         side,       side_d,      // initialise side with the globally provided simulation area side
         hue_scale,  hue_d,       // initialise hue_scale based on globally provided area side
+        oracle,     oracle_d,    // initialise oracle with the globally provided one
         speed,      speed_d      // initialise speed with the globally provided speed for new nodes
     >,
     // general parameters to use for plotting
@@ -241,7 +348,7 @@ DECLARE_OPTIONS(list,
         hops,   double,
         speed,  double
     >,
-    plot_type<plot_t>, // the plot description to be used
+    plot_type<P>, // the plot description to be used
     dimension<dim>, // dimensionality of the space
     connector<connect::fixed<comm, 1, dim>>, // connection allowed within a fixed comm range
     shape_tag<node_shape>, // the shape of a node is read from this tag in the store
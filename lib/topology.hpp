@@ -0,0 +1,188 @@
+// Copyright © 2026 Giorgio Audrito. All Rights Reserved.
+
+/**
+ * @file topology.hpp
+ * @brief Detection of the NUMA layout of the machine, and binding of processes to NUMA domains.
+ */
+
+#ifndef FCPP_TOPOLOGY_H_
+#define FCPP_TOPOLOGY_H_
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+#ifdef FCPP_MPI
+#include <mpi.h>
+#endif
+
+
+/**
+ * @brief Namespace containing all the objects in the FCPP library.
+ */
+namespace fcpp {
+
+
+//! @brief Namespace containing tools for batch execution of simulations.
+namespace batch {
+
+
+//! @brief A NUMA domain (or socket, if NUMA information is missing) with its CPUs.
+struct numa_domain {
+    //! @brief The identifier of the domain.
+    int id;
+    //! @brief The CPUs of the domain.
+    std::vector<int> cpus;
+};
+
+
+//! @brief Parses a list of CPUs in the format of `/sys` (e.g. "0-3,8-11").
+inline std::vector<int> parse_cpu_list(std::string const& s) {
+    std::vector<int> v;
+    std::stringstream ss(s);
+    std::string r;
+    while (std::getline(ss, r, ',')) {
+        if (r.find_first_of("0123456789") == std::string::npos) continue;
+        size_t d = r.find('-');
+        int a = std::atoi(r.c_str());
+        int b = d == std::string::npos ? a : std::atoi(r.c_str() + d + 1);
+        for (int i = a; i <= b; ++i) v.push_back(i);
+    }
+    return v;
+}
+
+
+/**
+ * @brief The NUMA domains of the machine, sorted by identifier.
+ *
+ * Domains are read from `/sys/devices/system/node`, falling back to the physical packages (sockets) of
+ * `/sys/devices/system/cpu`, and to a single domain with every CPU if neither is available. Only CPUs
+ * available to the calling process are listed (as listed in `/proc/self/status`), and empty domains
+ * (e.g. memory-only nodes) are omitted.
+ */
+inline std::vector<numa_domain> numa_domains() {
+    std::vector<int> allowed;
+    {
+        std::ifstream f("/proc/self/status");
+        std::string line;
+        while (std::getline(f, line))
+            if (line.compare(0, 19, "Cpus_allowed_list:\t") == 0) allowed = parse_cpu_list(line.substr(19));
+    }
+    if (allowed.empty()) for (int i = 0; i < int(std::max(std::thread::hardware_concurrency(), 1u)); ++i) allowed.push_back(i);
+    std::sort(allowed.begin(), allowed.end());
+    std::map<int, std::vector<int>> domains;
+    std::string nodes;
+    std::getline(std::ifstream("/sys/devices/system/node/online"), nodes);
+    for (int n : parse_cpu_list(nodes)) {
+        std::ifstream f("/sys/devices/system/node/node" + std::to_string(n) + "/cpulist");
+        std::string s;
+        if (std::getline(f, s)) domains[n] = parse_cpu_list(s);
+    }
+    if (domains.empty()) for (int c : allowed) {
+        std::ifstream f("/sys/devices/system/cpu/cpu" + std::to_string(c) + "/topology/physical_package_id");
+        int p = 0;
+        f >> p;
+        domains[p].push_back(c);
+    }
+    std::vector<numa_domain> v;
+    for (auto const& d : domains) {
+        numa_domain x{d.first, {}};
+        for (int c : d.second) if (std::binary_search(allowed.begin(), allowed.end(), c)) x.cpus.push_back(c);
+        if (x.cpus.size()) v.push_back(x);
+    }
+    if (v.empty()) v.push_back(numa_domain{0, allowed});
+    return v;
+}
+
+
+//! @brief The rank of the process among the MPI processes on the same machine, as given by the launcher (or a default).
+inline int local_rank(int def) {
+    for (char const* e : {"OMPI_COMM_WORLD_LOCAL_RANK", "MPI_LOCALRANKID", "MV2_COMM_WORLD_LOCAL_RANK", "SLURM_LOCALID"})
+        if (char const* v = std::getenv(e)) return std::atoi(v);
+    return def;
+}
+
+
+//! @brief The number of MPI processes on the same machine, as given by the launcher (or a default).
+inline int local_size(int def) {
+    for (char const* e : {"OMPI_COMM_WORLD_LOCAL_SIZE", "MPI_LOCALNRANKS", "MV2_COMM_WORLD_LOCAL_SIZE", "SLURM_NTASKS_PER_NODE"})
+        if (char const* v = std::getenv(e)) return std::atoi(v);
+    return def;
+}
+
+
+//! @brief The minimum of a value among all MPI processes (the value itself without MPI).
+inline size_t min_among_processes(size_t v) {
+#ifdef FCPP_MPI
+    unsigned long long x = v, m = v;
+    MPI_Allreduce(&x, &m, 1, MPI_UNSIGNED_LONG_LONG, MPI_MIN, MPI_COMM_WORLD);
+    return m;
+#else
+    return v;
+#endif
+}
+
+
+/**
+ * @brief Binds the calling thread to a set of CPUs while alive, restoring the previous binding on destruction.
+ *
+ * Threads created by the bound thread inherit the binding, so that binding the main thread of a process to a NUMA
+ * domain before running a batch pins every worker thread to the domain. Since the kernel allocates memory on the
+ * domain of the thread first touching it, and every simulation is constructed and run by a single worker thread,
+ * the memory of simulations is then local to the domain. Does nothing outside Linux.
+ */
+class cpu_binding {
+  public:
+    //! @brief Binds the calling thread to given CPUs.
+    explicit cpu_binding(std::vector<int> const& cpus) {
+#ifdef __linux__
+        m_bound = sched_getaffinity(0, sizeof(m_previous), &m_previous) == 0;
+        cpu_set_t s;
+        CPU_ZERO(&s);
+        for (int c : cpus) CPU_SET(c, &s);
+        m_bound = m_bound and sched_setaffinity(0, sizeof(s), &s) == 0;
+#else
+        (void)cpus;
+#endif
+    }
+
+    //! @brief Copies are not allowed.
+    cpu_binding(cpu_binding const&) = delete;
+
+    //! @brief Restores the previous binding.
+    ~cpu_binding() {
+#ifdef __linux__
+        if (m_bound) sched_setaffinity(0, sizeof(m_previous), &m_previous);
+#endif
+    }
+
+    //! @brief Whether the binding succeeded.
+    bool bound() const {
+        return m_bound;
+    }
+
+  private:
+    //! @brief Whether the binding succeeded.
+    bool m_bound = false;
+#ifdef __linux__
+    //! @brief The previous binding.
+    cpu_set_t m_previous;
+#endif
+};
+
+
+} // namespace batch
+
+
+} // namespace fcpp
+
+#endif // FCPP_TOPOLOGY_H_
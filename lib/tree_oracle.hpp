@@ -0,0 +1,68 @@
+// Copyright © 2026 Giorgio Audrito. All Rights Reserved.
+
+/**
+ * @file tree_oracle.hpp
+ * @brief Ground-truth oracle of the ancestors of every device in a spanning tree, shared by every node of a network.
+ */
+
+#ifndef FCPP_TREE_ORACLE_H_
+#define FCPP_TREE_ORACLE_H_
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "lib/settings.hpp"
+
+
+/**
+ * @brief Namespace containing all the objects in the FCPP library.
+ */
+namespace fcpp {
+
+
+/**
+ * @brief Oracle serving whether a device is an ancestor of another in a spanning tree (for statistics only).
+ *
+ * Every device publishes once per round its path to the root (itself, its parent, and the path published by
+ * the parent), as an immutable vector swapped in atomically. Queries then load a single path, with no reads
+ * on the state of other nodes. Paths are cut when they loop back to the device, as parents of different nodes
+ * may be computed in different rounds. Meant to be shared among the nodes of a single network (e.g. through a
+ * `std::shared_ptr` in the node storage), whose identifiers are below the number of devices given.
+ */
+class tree_oracle {
+  public:
+    //! @brief Constructor given the number of devices.
+    explicit tree_oracle(size_t devices) : m_paths(devices) {}
+
+    //! @brief Publishes the path to the root of a device, given its parent (equal to the device itself for roots).
+    void publish(device_t id, device_t parent) {
+        if (id >= m_paths.size()) return;
+        auto p = std::make_shared<path_t>(1, id);
+        if (parent != id and parent < m_paths.size()) {
+            std::shared_ptr<path_t const> q = std::atomic_load(&m_paths[parent]);
+            p->push_back(parent);
+            if (q) for (size_t i = 1; i < q->size() and (*q)[i] != id; ++i) p->push_back((*q)[i]);
+        }
+        std::atomic_store(&m_paths[id], std::shared_ptr<path_t const>(std::move(p)));
+    }
+
+    //! @brief Whether a device is an ancestor of another (or the device itself), according to the last path published.
+    bool ancestor(device_t a, device_t d) const {
+        if (d >= m_paths.size()) return false;
+        std::shared_ptr<path_t const> p = std::atomic_load(&m_paths[d]);
+        return p and std::find(p->begin(), p->end(), a) != p->end();
+    }
+
+  private:
+    //! @brief Type of paths to the root.
+    using path_t = std::vector<device_t>;
+
+    //! @brief The paths to the root last published by each device.
+    std::vector<std::shared_ptr<path_t const>> m_paths;
+};
+
+
+} // namespace fcpp
+
+#endif // FCPP_TREE_ORACLE_H_
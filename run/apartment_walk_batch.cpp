@@ -0,0 +1,77 @@
+// Copyright © 2026 Giorgio Audrito. All Rights Reserved.
+
+/**
+ * @file apartment_walk_batch.cpp
+ * @brief Runs the apartment walk non-interactively with growing crowds, printing wall time per simulated second, neighbour counts and distances between people.
+ *
+ * An optional argument gives the largest number of people to be simulated (20000 by default).
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+
+#include "lib/apartment_walk.hpp"
+
+using namespace fcpp;
+
+//! @brief Runs a single execution with given people, speed and seed, printing the measures.
+void measure(size_t people, double speed, int seed) {
+    //! @brief The network object type (batch simulator with given options, without multithreading on node rounds).
+    using net_t = component::batch_simulator<option::list<true, false>>::net;
+    //! @brief The initialisation values (random seed, no logging, number of people, speed, obstacles if not cached).
+    auto init_v = common::make_tagged_tuple<option::seed, option::output, option::people, option::speed, option::obstacles, option::obstacles_color_threshold>(
+        seed,
+        nullptr,
+        people,
+        speed,
+        coordination::floor_plan_cache().ready() ? "" : floor_plan_image,
+        obstacle_threshold
+    );
+    //! @brief Construct the network object.
+    net_t network{init_v};
+    //! @brief Run the simulation until exit, measuring time.
+    auto start = std::chrono::high_resolution_clock::now();
+    network.run();
+    double t = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+    //! @brief Collects round and neighbour counters, and final distances from the closest neighbour.
+    size_t rounds = 0, nbrs = 0, isolated = 0, close = 0;
+    real_t dmin = std::numeric_limits<real_t>::max(), dsum = 0;
+    for (device_t i = 0; i < people; ++i) if (network.node_count(i)) {
+        auto const& n = network.node_at(i);
+        rounds += n.storage(option::round_count{});
+        nbrs   += n.storage(option::nbr_total{});
+        real_t d = n.storage(option::distance_min_nbr{});
+        if (d == std::numeric_limits<real_t>::max()) {
+            ++isolated;
+            continue;
+        }
+        dmin = std::min(dmin, d);
+        dsum += d;
+        close += d <= repulsion_radius;
+    }
+    size_t paired = people - isolated;
+    std::cout << std::setw(8) << people << std::setw(7) << speed << std::setw(6) << seed
+              << std::setw(12) << std::setprecision(4) << t / end_time
+              << std::setw(12) << rounds / t
+              << std::setw(10) << double(nbrs) / rounds
+              << std::setw(10) << (paired ? dmin : NAN)
+              << std::setw(10) << (paired ? dsum / paired : NAN)
+              << std::setw(10) << 100.0 * close / people
+              << std::setw(10) << 100.0 * isolated / people << std::endl;
+}
+
+int main(int argc, char** argv) {
+    size_t max_people = argc > 1 ? std::atol(argv[1]) : 20000;
+    std::cout << std::setw(8) << "people" << std::setw(7) << "speed" << std::setw(6) << "seed"
+              << std::setw(12) << "wall s/s" << std::setw(12) << "rounds/s" << std::setw(10) << "nbrs"
+              << std::setw(10) << "dist min" << std::setw(10) << "dist avg"
+              << std::setw(10) << "close %" << std::setw(10) << "alone %" << std::endl;
+    for (size_t people : {10, 100, 1000, 5000, 10000, 20000}) if (people <= max_people)
+        for (double speed : {1, 3, 10})
+            for (int seed = 0; seed < 2; ++seed)
+                measure(people, speed, seed);
+    return 0;
+}
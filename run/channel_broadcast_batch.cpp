@@ -0,0 +1,119 @@
+// Copyright © 2026 Giorgio Audrito. All Rights Reserved.
+
+/**
+ * @file channel_broadcast_batch.cpp
+ * @brief Runs the channel broadcast non-interactively with the fixed and the adaptive round schedules, printing rounds, messages and accuracy of the channel.
+ *
+ * Accuracy is the fraction of time in which the channel output held by nodes agrees with the true channel (computed from
+ * positions through oracles with a quantum of one second, the average round period, reading endpoints under their lock).
+ * The hit rate of the oracles is printed as well. An optional argument gives the number of random seeds (5 by default).
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include "lib/channel_broadcast.hpp"
+
+using namespace fcpp;
+
+//! @brief The measures of a run (or of multiple runs).
+struct totals {
+    //! @brief Rounds performed (each sending a message).
+    size_t rounds = 0;
+    //! @brief Messages received (each once, however long it is retained).
+    size_t received = 0;
+    //! @brief Time in which the channel output of nodes was wrong.
+    double error = 0;
+    //! @brief Time in which the channel output of nodes was checked.
+    double tracked = 0;
+    //! @brief Wall time of the runs.
+    double wall = 0;
+    //! @brief Positions served by the oracles from a previous computation.
+    size_t hits = 0;
+    //! @brief Positions computed by the oracles.
+    size_t misses = 0;
+
+    //! @brief Adds the measures of another run.
+    totals& operator+=(totals const& o) {
+        rounds += o.rounds;
+        received += o.received;
+        error += o.error;
+        tracked += o.tracked;
+        wall += o.wall;
+        hits += o.hits;
+        misses += o.misses;
+        return *this;
+    }
+};
+
+//! @brief Runs a single execution with a fixed or adaptive schedule and a given seed, returning its measures.
+template <bool adaptive>
+totals measure(int seed) {
+    //! @brief The network object type (batch simulator with given options).
+    using net_t = typename component::batch_simulator<option::list<adaptive, true>>::net;
+    //! @brief Fresh oracles of source and destination positions, sharing positions within each second.
+    auto src = std::make_shared<position_oracle<dim>>(1);
+    auto dst = std::make_shared<position_oracle<dim>>(1);
+    //! @brief The initialisation values (random seed, no logging, oracles).
+    auto init_v = common::make_tagged_tuple<option::seed, option::output, option::source_oracle, option::dest_oracle>(
+        seed,
+        nullptr,
+        src,
+        dst
+    );
+    //! @brief Construct the network object.
+    net_t network{init_v};
+    //! @brief Run the simulation until exit, measuring time.
+    auto start = std::chrono::high_resolution_clock::now();
+    network.run();
+    totals r;
+    r.wall = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+    r.hits = src->hits() + dst->hits();
+    r.misses = src->misses() + dst->misses();
+    //! @brief Collects the counters of every node.
+    for (device_t i = 0; i < devices; ++i) if (network.node_count(i)) {
+        auto const& n = network.node_at(i);
+        r.rounds   += n.storage(option::round_count{});
+        r.received += n.storage(option::nbr_total{});
+        r.error    += n.storage(option::error_time{});
+        r.tracked  += n.storage(option::tracked_time{});
+    }
+    return r;
+}
+
+//! @brief Prints the measures of a schedule.
+void print(char const* schedule, char const* seed, totals const& t) {
+    std::cout << std::setw(10) << schedule << std::setw(6) << seed
+              << std::setw(12) << t.rounds << std::setw(12) << t.received
+              << std::setw(12) << std::setprecision(4) << 100 * (1 - t.error / t.tracked)
+              << std::setw(10) << t.wall
+              << std::setw(10) << 100.0 * t.hits / (t.hits + t.misses) << std::endl;
+}
+
+int main(int argc, char** argv) {
+    int seeds = argc > 1 ? std::atoi(argv[1]) : 5;
+    std::cout << std::setw(10) << "schedule" << std::setw(6) << "seed"
+              << std::setw(12) << "rounds" << std::setw(12) << "messages"
+              << std::setw(12) << "accuracy %" << std::setw(10) << "wall s"
+              << std::setw(10) << "oracle %" << std::endl;
+    totals fixed, adaptive;
+    for (int seed = 0; seed < seeds; ++seed) {
+        totals f = measure<false>(seed), a = measure<true>(seed);
+        std::string s = std::to_string(seed);
+        print("fixed", s.c_str(), f);
+        print("adaptive", s.c_str(), a);
+        fixed += f;
+        adaptive += a;
+    }
+    print("fixed", "all", fixed);
+    print("adaptive", "all", adaptive);
+    std::cout << "adaptive schedule: " << std::setprecision(3)
+              << 100.0 * adaptive.rounds / fixed.rounds << "% of rounds, "
+              << 100.0 * adaptive.received / fixed.received << "% of messages, accuracy "
+              << std::showpos << 100 * (fixed.error / fixed.tracked - adaptive.error / adaptive.tracked) << std::noshowpos
+              << " points against the fixed schedule" << std::endl;
+    return 0;
+}
@@ -42,7 +42,8 @@ DECLARE_OPTIONS(opt,
         spc_max,    double,
         mpc_max,    double,
         wmpc_max,   double,
-        ideal_max,  double
+        ideal_max,  double,
+        oracle,     std::shared_ptr<position_oracle<2>>
     >,
     aggregators<
         spc_sum,    aggregator::sum<double>,
@@ -56,14 +57,15 @@ DECLARE_OPTIONS(opt,
     >,
     init<
         x,          rectangle_d,
-        algorithm,  distribution::constant_n<int, algo>
+        algorithm,  distribution::constant_n<int, algo>,
+        oracle,     distribution::constant_i<std::shared_ptr<position_oracle<2>>, oracle>
     >,
     connector<connect::fixed<100>>
 );
 
 int main() {
     using net_t = component::batch_simulator<opt>::net;
-    auto init_v = common::make_tagged_tuple<epsilon>(0.1);
+    auto init_v = common::make_tagged_tuple<epsilon, oracle>(0.1, std::make_shared<position_oracle<2>>());
     net_t network{init_v};
     network.run();
     return 0;
@@ -0,0 +1,90 @@
+// Copyright © 2026 Giorgio Audrito. All Rights Reserved.
+
+/**
+ * @file flat_hash_benchmark.cpp
+ * @brief Compares insertion and lookup throughput and allocations of flat and standard hash containers on messages.
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <random>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "lib/message_dispatch.hpp"
+
+using namespace fcpp;
+
+//! @brief The number of heap allocations performed so far.
+static size_t allocations = 0;
+
+//! @brief Counting allocation function.
+void* operator new(size_t n) {
+    ++allocations;
+    if (void* p = std::malloc(n)) return p;
+    throw std::bad_alloc();
+}
+
+//! @brief Deallocation function matching the counting allocation.
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+//! @brief Deallocation function matching the counting allocation (sized overload).
+void operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
+
+//! @brief Seconds elapsed since a given time point.
+inline double elapsed(std::chrono::high_resolution_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+//! @brief Measures a container on given keys, printing millions of operations per second and allocations.
+template <typename C, typename I>
+void measure(std::string name, std::vector<message> const& keys, I&& inserter) {
+    C c;
+    size_t a = allocations;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (message const& m : keys) inserter(c, m);
+    double ti = elapsed(start);
+    a = allocations - a;
+    size_t found = 0;
+    start = std::chrono::high_resolution_clock::now();
+    for (message const& m : keys) found += c.count(m);
+    for (message const& m : keys) found += c.count(message(m.to, m.from, m.time + 0.5));
+    double tl = elapsed(start);
+    std::cout << std::setw(16) << name << std::setw(10) << keys.size()
+              << std::setw(14) << keys.size() / ti * 1e-6
+              << std::setw(14) << 2 * keys.size() / tl * 1e-6
+              << std::setw(14) << a
+              << std::setw(10) << (found == keys.size() ? "ok" : "error") << std::endl;
+}
+
+int main() {
+    std::mt19937_64 gen(42);
+    std::cout << std::setw(16) << "container" << std::setw(10) << "size"
+              << std::setw(14) << "insert Mop/s" << std::setw(14) << "lookup Mop/s"
+              << std::setw(14) << "allocations" << std::setw(10) << "check" << std::endl;
+    for (size_t n : {10000, 100000, 1000000}) {
+        // messages with large device identifiers and fractional times
+        std::vector<message> keys;
+        for (size_t i = 0; i < n; ++i)
+            keys.emplace_back(gen() % 10000000, gen() % 10000000, (gen() % 1000000) * 0.001);
+        auto set_ins = [](auto& c, message const& m) {
+            c.insert(m);
+        };
+        auto map_ins = [](auto& c, message const& m) {
+            c[m] = m.time;
+        };
+        measure<std::unordered_set<message, common::hash<message>>>("unordered_set", keys, set_ins);
+        measure<flat_set<message, common::hash<message>>>("flat_set", keys, set_ins);
+        measure<std::unordered_map<message, times_t, common::hash<message>>>("unordered_map", keys, map_ins);
+        measure<flat_map<message, times_t, common::hash<message>>>("flat_map", keys, map_ins);
+    }
+    return 0;
+}
@@ -0,0 +1,42 @@
+// Copyright © 2026 Giorgio Audrito. All Rights Reserved.
+
+/**
+ * @file message_dispatch_batch.cpp
+ * @brief Runs multiple executions of the message dispatch case study non-interactively from the command line, producing overall plots.
+ */
+
+#include "lib/message_dispatch.hpp"
+
+using namespace fcpp;
+
+int main() {
+    //! @brief Construct the plotter object.
+    option::batch_plot_t p;
+    //! @brief The component type (batch simulator with given options, no multithreading within runs).
+    using comp_t = component::batch_simulator<option::list<routing::exact, option::batch_plot_t, false, false>>;
+    //! @brief The list of initialisation values to be used for simulations.
+    auto init_list = batch::make_tagged_tuple_sequence(
+        batch::arithmetic<option::seed   >(0, 9, 1),               // 10 different random seeds
+        batch::arithmetic<option::devices>(100, 1000, 100, 300),   // 10 different device counts
+        batch::arithmetic<option::dens   >(5, 30, 5, 10),          // 6 different densities
+        batch::arithmetic<option::rate   >(0.5, 4.0, 0.5, 1.0),    // 8 different message rates
+        // generate output file name for the run
+        batch::stringify<option::output>("output/message_dispatch_batch", "txt"),
+        // computes side length from devices and dens
+        batch::formula<option::side, size_t>([](auto const& x) {
+            double n = common::get<option::devices>(x);
+            double d = common::get<option::dens>(x);
+            return sqrt(n*3.141592653589793*comm*comm/d) + 0.5;
+        }),
+        // creates a fresh oracle of tree ancestors for the run
+        batch::formula<option::tree, std::shared_ptr<tree_oracle>>([](auto const& x) {
+            return std::make_shared<tree_oracle>(common::get<option::devices>(x));
+        }),
+        batch::constant<option::plotter>(&p) // reference to the plotter object
+    );
+    //! @brief Runs the given simulations, distributing them dynamically across all cores.
+    batch::run(comp_t{}, common::tags::dynamic_execution{}, init_list);
+    //! @brief Builds the resulting plots.
+    std::cout << plot::file("message_dispatch_batch", p.build());
+    return 0;
+}
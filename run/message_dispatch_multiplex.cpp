@@ -0,0 +1,38 @@
+// Copyright © 2026 Giorgio Audrito. All Rights Reserved.
+
+/**
+ * @file message_dispatch_multiplex.cpp
+ * @brief Runs the message dispatch case study non-interactively with one process per message and per batch of messages, comparing process counts and message sizes.
+ */
+
+#include "lib/message_dispatch.hpp"
+
+using namespace fcpp;
+
+//! @brief Runs the simulations for a given dispatch mode.
+template <bool batched>
+void run_mode(option::multiplex_plot_t& p) {
+    //! @brief The component type (batch simulator with given options).
+    using comp_t = component::batch_simulator<option::list<routing::exact, option::multiplex_plot_t, batched>>;
+    //! @brief The list of initialisation values to be used for simulations.
+    auto init_list = batch::make_tagged_tuple_sequence(
+        batch::arithmetic<option::seed>(0, 4, 1), // 5 different random seeds
+        batch::constant<option::multiplexed, option::plotter, option::output, option::devices, option::side, option::rate>(int(batched), &p, nullptr, default_devices, default_side, 1),
+        // creates a fresh oracle of tree ancestors for the run
+        batch::formula<option::tree, std::shared_ptr<tree_oracle>>([](auto const&) {
+            return std::make_shared<tree_oracle>(default_devices);
+        })
+    );
+    //! @brief Runs the given simulations.
+    batch::run(comp_t{}, init_list);
+}
+
+int main() {
+    //! @brief Construct the plotter object.
+    option::multiplex_plot_t p;
+    run_mode<false>(p); // one process per message
+    run_mode<true>(p);  // one process per batch of messages
+    //! @brief Builds the resulting plots.
+    std::cout << plot::file("message_dispatch_multiplex", p.build());
+    return 0;
+}
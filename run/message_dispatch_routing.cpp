@@ -0,0 +1,41 @@
+// Copyright © 2026 Giorgio Audrito. All Rights Reserved.
+
+/**
+ * @file message_dispatch_routing.cpp
+ * @brief Runs the message dispatch case study non-interactively with different routing summaries, comparing message sizes and false routing.
+ */
+
+#include "lib/message_dispatch.hpp"
+
+using namespace fcpp;
+
+//! @brief Runs the simulations for a given routing summary type, identified by a given number.
+template <typename R>
+void run_summary(option::summary_plot_t& p, int id) {
+    //! @brief The component type (batch simulator with given options).
+    using comp_t = component::batch_simulator<option::list<R, option::summary_plot_t>>;
+    //! @brief The list of initialisation values to be used for simulations.
+    auto init_list = batch::make_tagged_tuple_sequence(
+        batch::arithmetic<option::seed>(0, 4, 1), // 5 different random seeds
+        batch::constant<option::summary, option::plotter, option::output, option::devices, option::side, option::rate>(id, &p, nullptr, default_devices, default_side, 1),
+        // creates a fresh oracle of tree ancestors for the run
+        batch::formula<option::tree, std::shared_ptr<tree_oracle>>([](auto const&) {
+            return std::make_shared<tree_oracle>(default_devices);
+        })
+    );
+    //! @brief Runs the given simulations.
+    batch::run(comp_t{}, init_list);
+}
+
+int main() {
+    //! @brief Construct the plotter object.
+    option::summary_plot_t p;
+    run_summary<routing::exact>(p, 0);                   // the reference exact set of devices
+    run_summary<routing::interval<8>>(p, 1);             // at most 8 intervals of identifiers
+    run_summary<routing::bloom<4>>(p, 2);                // Bloom filter of 256 bits
+    run_summary<routing::bitset<default_devices>>(p, 3); // one bit per device
+    run_summary<delta_encoded<routing::exact>>(p, 4);    // the exact set, exchanging insertions and deletions
+    //! @brief Builds the resulting plots.
+    std::cout << plot::file("message_dispatch_routing", p.build());
+    return 0;
+}
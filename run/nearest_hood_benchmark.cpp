@@ -0,0 +1,109 @@
+// Copyright © 2026 Giorgio Audrito. All Rights Reserved.
+
+/**
+ * @file nearest_hood_benchmark.cpp
+ * @brief Compares the repulsion of apartment walkers computed through intermediate fields and in a single pass, as crowds grow denser.
+ *
+ * Both compute the distance of the closest neighbour and the springs towards the whole neighbourhood (the same
+ * physics), and are checked to agree up to rounding.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "lib/nearest_hood.hpp"
+#include "lib/neighbour_list.hpp"
+
+using namespace fcpp;
+
+//! @brief Dimensionality of the space.
+constexpr size_t dim = 3;
+//! @brief Side of the deployment area.
+constexpr size_t width = 850;
+//! @brief Height of the deployment area.
+constexpr size_t height = 500;
+//! @brief Tallness of the deployment area.
+constexpr size_t tall = 50;
+//! @brief Communication radius.
+constexpr real_t comm = 100;
+//! @brief Distance within which people repel each other.
+constexpr real_t repulsion_radius = 25;
+
+//! @brief Seconds elapsed since a given time point.
+inline double elapsed(std::chrono::high_resolution_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+//! @brief The elastic force towards a neighbour, as in `neighbour_elastic_force`.
+inline vec<dim> spring(vec<dim> const& v, real_t d, real_t length, real_t strength) {
+    return d > 0 ? v * (strength * (d - length) / d) : v * 0;
+}
+
+int main() {
+    std::mt19937_64 gen(42);
+    std::uniform_real_distribution<real_t> ux(0, width), uy(0, height);
+    std::cout << std::setw(8) << "people" << std::setw(8) << "nbrs"
+              << std::setw(14) << "field us/rnd" << std::setw(14) << "pass us/rnd"
+              << std::setw(9) << "speedup" << std::setw(8) << "check" << std::endl;
+    for (size_t people : {100, 1000, 5000, 10000, 20000}) {
+        std::vector<vec<dim>> pos;
+        for (size_t i = 0; i < people; ++i) pos.push_back(make_vec(ux(gen), uy(gen), tall));
+        cell_grid<dim> grid(comm);
+        grid.build(pos);
+        // the neighbour vectors of every person, laid out contiguously as in a field
+        std::vector<size_t> start = {0};
+        std::vector<vec<dim>> nbr_vec;
+        for (size_t i = 0; i < people; ++i) {
+            grid.for_each_neighbour(i, pos, comm, [&](size_t j){
+                nbr_vec.push_back(pos[j] - pos[i]);
+            });
+            start.push_back(nbr_vec.size());
+        }
+        size_t rounds = std::max<size_t>(2000000 / nbr_vec.size(), 1);
+        // as `min_hood` of `nbr_dist()` and `neighbour_elastic_force`: every step produces a field
+        std::vector<real_t> full_min(people);
+        std::vector<vec<dim>> full_force(people);
+        auto t0 = std::chrono::high_resolution_clock::now();
+        for (size_t r = 0; r < rounds; ++r) for (size_t i = 0; i < people; ++i) {
+            std::vector<real_t> nbr_dist;
+            for (size_t j = start[i]; j < start[i+1]; ++j) nbr_dist.push_back(norm(nbr_vec[j]));
+            real_t m = std::numeric_limits<real_t>::max();
+            for (real_t d : nbr_dist) m = std::min(m, d);
+            vec<dim> f = make_vec(0, 0, 0);
+            if (m <= repulsion_radius) {
+                std::vector<vec<dim>> springs;
+                for (size_t j = start[i]; j < start[i+1]; ++j) springs.push_back(spring(nbr_vec[j], norm(nbr_vec[j]), 0.05, 0.05));
+                for (vec<dim> const& s : springs) f = f + s;
+            }
+            full_min[i] = m;
+            full_force[i] = f;
+        }
+        double tf = elapsed(t0);
+        // single pass, as `nearest_hood`
+        std::vector<real_t> pass_min(people);
+        std::vector<vec<dim>> pass_force(people);
+        t0 = std::chrono::high_resolution_clock::now();
+        for (size_t r = 0; r < rounds; ++r) for (size_t i = 0; i < people; ++i) {
+            hood_springs<dim> s(0.05, 0.05);
+            for (size_t j = start[i]; j < start[i+1]; ++j) s.insert(nbr_vec[j]);
+            real_t m = s.closest();
+            pass_min[i] = m;
+            pass_force[i] = m <= repulsion_radius ? s.elastic_force() : make_vec(0, 0, 0);
+        }
+        double tp = elapsed(t0);
+        // minima and forces must agree up to rounding
+        bool ok = true;
+        for (size_t i = 0; ok and i < people; ++i)
+            ok = std::abs(pass_min[i] - full_min[i]) <= 1e-9 * full_min[i] and norm(pass_force[i] - full_force[i]) <= 1e-9 * (1 + norm(full_force[i]));
+        std::cout << std::setw(8) << people << std::setw(8) << std::setprecision(4) << double(nbr_vec.size()) / people
+                  << std::setw(14) << tf / rounds * 1e6 << std::setw(14) << tp / rounds * 1e6
+                  << std::setw(9) << std::setprecision(3) << tf / tp << std::setw(8) << (ok ? "ok" : "error") << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,198 @@
+// Copyright © 2026 Giorgio Audrito. All Rights Reserved.
+
+/**
+ * @file neighbour_list_benchmark.cpp
+ * @brief Compares the rounds per second of neighbour search as in the simulated connector of FCPP with `connect::fixed` and through a Verlet list, across densities and speeds of the spreading collection case study.
+ */
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include "lib/neighbour_list.hpp"
+#include "lib/spreading_collection.hpp"
+
+using namespace fcpp;
+
+//! @brief Seconds elapsed since a given time point.
+inline double elapsed(std::chrono::high_resolution_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+/**
+ * @brief Neighbour search of the simulated connector of FCPP with `connect::fixed` (connection within a radius).
+ *
+ * Devices are kept in cubic cells of side the radius, stored in a hash map and linked to their neighbouring cells on
+ * creation. A device is moved only when it changes cell, and finds its neighbours among the devices in the cells linked
+ * to its own. The connector also extrapolates positions and calls the connection predicate on every pair, so that its
+ * actual cost is higher.
+ *
+ * @param n The dimensionality of positions.
+ */
+template <size_t n>
+class fixed_search {
+  public:
+    //! @brief Constructor given the connection radius.
+    explicit fixed_search(double radius) : m_radius(radius) {}
+
+    //! @brief Updates the cells to new positions (of the same devices).
+    void update(std::vector<vec<n>> const& pos) {
+        if (pos.size() != m_key.size()) {
+            m_cells.clear();
+            m_key.clear();
+            for (size_t i = 0; i < pos.size(); ++i) {
+                m_key.push_back(key_of(pos[i]));
+                cell_at(m_key[i]).content.push_back(i);
+            }
+            return;
+        }
+        for (size_t i = 0; i < pos.size(); ++i) {
+            key_t k = key_of(pos[i]);
+            if (k == m_key[i]) continue;
+            std::vector<size_t>& c = m_cells.at(m_key[i]).content;
+            *std::find(c.begin(), c.end(), i) = c.back();
+            c.pop_back();
+            m_key[i] = k;
+            cell_at(k).content.push_back(i);
+        }
+    }
+
+    //! @brief Calls `f(j)` for every neighbour `j` of device `i`, given the current positions.
+    template <typename F>
+    void for_each_neighbour(size_t i, std::vector<vec<n>> const& pos, F&& f) const {
+        double r2 = m_radius * m_radius;
+        for (cell const* c : m_cells.at(m_key[i]).linked)
+            for (size_t j : c->content)
+                if (j != i and cell_grid<n>::sqr_distance(pos[i], pos[j]) <= r2) f(j);
+    }
+
+  private:
+    //! @brief The coordinates of a cell.
+    using key_t = std::array<int64_t, n>;
+
+    //! @brief Hasher of cell coordinates.
+    struct hasher {
+        size_t operator()(key_t const& k) const {
+            size_t h = 0;
+            for (int64_t x : k) h = h * 1000003 ^ std::hash<int64_t>{}(x);
+            return h;
+        }
+    };
+
+    //! @brief A cell, with its devices and the cells around it (itself included).
+    struct cell {
+        //! @brief The devices in the cell.
+        std::vector<size_t> content;
+        //! @brief The existing cells around it.
+        std::vector<cell const*> linked;
+    };
+
+    //! @brief The cell of a position.
+    key_t key_of(vec<n> const& p) const {
+        key_t k;
+        for (size_t i = 0; i < n; ++i) k[i] = int64_t(std::floor(p[i] / m_radius));
+        return k;
+    }
+
+    //! @brief The cell with given coordinates, created and linked to the cells around it if missing.
+    cell& cell_at(key_t const& k) {
+        auto it = m_cells.find(k);
+        if (it != m_cells.end()) return it->second;
+        cell& c = m_cells[k];
+        key_t d;
+        d.fill(-1);
+        while (true) {
+            key_t h = k;
+            for (size_t i = 0; i < n; ++i) h[i] += d[i];
+            auto jt = m_cells.find(h);
+            if (jt != m_cells.end()) {
+                c.linked.push_back(&jt->second);
+                if (&jt->second != &c) jt->second.linked.push_back(&c);
+            }
+            size_t i = 0;
+            while (i < n and d[i] == 1) d[i] = -1, ++i;
+            if (i == n) return c;
+            ++d[i];
+        }
+    }
+
+    //! @brief The connection radius.
+    double m_radius;
+    //! @brief The cells (never removed, as in the connector).
+    std::unordered_map<key_t, cell, hasher> m_cells;
+    //! @brief The cell of every device.
+    std::vector<key_t> m_key;
+};
+
+//! @brief Positions of devices walking towards random targets in the deployment area at a given speed, one vector per round.
+std::vector<std::vector<vec<dim>>> trajectories(size_t devices, double side, double speed, std::mt19937_64& gen) {
+    std::uniform_real_distribution<double> ux(0, side), uz(0, height);
+    auto random_point = [&](){
+        return make_vec(ux(gen), ux(gen), uz(gen));
+    };
+    std::vector<vec<dim>> pos, target;
+    for (size_t i = 0; i < devices; ++i) {
+        pos.push_back(random_point());
+        target.push_back(random_point());
+    }
+    std::vector<std::vector<vec<dim>>> v;
+    for (size_t t = 0; t <= end_time; ++t) {
+        v.push_back(pos);
+        for (size_t i = 0; i < devices; ++i) {
+            double d = norm(target[i] - pos[i]);
+            if (d <= speed) {
+                pos[i] = target[i];
+                target[i] = random_point();
+            } else pos[i] = pos[i] + (target[i] - pos[i]) * (speed / d);
+        }
+    }
+    return v;
+}
+
+int main() {
+    std::mt19937_64 gen(42);
+    double side = 10 * comm / sqrt(2.0) + 0.5;
+    std::cout << std::setw(6) << "dens" << std::setw(7) << "speed" << std::setw(9) << "devices" << std::setw(8) << "nbrs"
+              << std::setw(12) << "fixed r/s" << std::setw(7) << "skin" << std::setw(10) << "rebuilds"
+              << std::setw(12) << "verlet r/s" << std::setw(9) << "speedup" << std::setw(8) << "check" << std::endl;
+    for (size_t dens : {5, 10, 20, 29}) for (size_t speed : {0, 2, 10, 48}) {
+        size_t devices = dens*side*side/(3.141592653589793*comm*comm) + 0.5;
+        // speed in percentage of the communication radius per second, as in the case study
+        auto traj = trajectories(devices, side, speed * comm / 100.0, gen);
+        size_t fixed_count = 0;
+        auto start = std::chrono::high_resolution_clock::now();
+        fixed_search<dim> fixed(comm);
+        for (auto const& pos : traj) {
+            fixed.update(pos);
+            for (size_t i = 0; i < pos.size(); ++i) fixed.for_each_neighbour(i, pos, [&](size_t){
+                ++fixed_count;
+            });
+        }
+        double fixed_rate = traj.size() / elapsed(start);
+        for (double skin : {10, 25, 50}) {
+            size_t verlet_count = 0;
+            start = std::chrono::high_resolution_clock::now();
+            verlet_list<dim> list(comm, skin);
+            for (auto const& pos : traj) {
+                list.update(pos);
+                for (size_t i = 0; i < pos.size(); ++i) list.for_each_neighbour(i, pos, [&](size_t){
+                    ++verlet_count;
+                });
+            }
+            double verlet_rate = traj.size() / elapsed(start);
+            std::cout << std::setw(6) << dens << std::setw(7) << speed << std::setw(9) << devices
+                      << std::setw(8) << std::setprecision(3) << double(fixed_count) / traj.size() / devices
+                      << std::setw(12) << std::setprecision(5) << fixed_rate << std::setw(7) << skin << std::setw(10) << list.rebuilds()
+                      << std::setw(12) << verlet_rate << std::setw(9) << std::setprecision(3) << verlet_rate / fixed_rate
+                      << std::setw(8) << (verlet_count == fixed_count ? "ok" : "error") << std::endl;
+        }
+    }
+    return 0;
+}
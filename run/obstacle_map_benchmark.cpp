@@ -0,0 +1,165 @@
+// Copyright © 2026 Giorgio Audrito. All Rights Reserved.
+
+/**
+ * @file obstacle_map_benchmark.cpp
+ * @brief Compares obstacle queries by a ring search on the bitmap and through the precomputed feature transform of an obstacle map, as the number of walking people grows, and the startup time of computing and memory-mapping obstacle maps.
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "lib/obstacle_map.hpp"
+
+using namespace fcpp;
+
+//! @brief Dimensionality of the space.
+constexpr size_t dim = 3;
+//! @brief Side of the deployment area.
+constexpr size_t width = 850;
+//! @brief Height of the deployment area.
+constexpr size_t height = 500;
+//! @brief Tallness of the deployment area.
+constexpr size_t tall = 50;
+
+//! @brief Seconds elapsed since a given time point.
+inline double elapsed(std::chrono::high_resolution_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+//! @brief Whether a point is on an obstacle in a floor plan of 4x2 rooms with doors, outer walls and furniture.
+bool floor_plan(double x, double y) {
+    auto in = [&](double x0, double y0, double x1, double y1) {
+        return x0 <= x and x < x1 and y0 <= y and y < y1;
+    };
+    if (not in(10, 10, width-10, height-10)) return true;
+    for (int i = 1; i < 4; ++i) {
+        double wx = i * width / 4.0;
+        if (in(wx-3, 0, wx+3, height) and not in(0, 200, width, 250)) return true;
+    }
+    double wy = height / 2.0;
+    if (in(0, wy-3, width, wy+3)) for (int i = 0; i < 4; ++i) {
+        double dx = (i + 0.5) * width / 4.0;
+        if (not in(dx-30, 0, dx+30, height)) return true;
+    }
+    // a table in the middle of every room
+    for (int i = 0; i < 4; ++i) for (int j = 0; j < 2; ++j) {
+        double cx = (i + 0.5) * width / 4.0, cy = (j + 0.5) * height / 2.0 + (j ? 30 : -30);
+        if (in(cx-25, cy-15, cx+25, cy+15)) return true;
+    }
+    return false;
+}
+
+//! @brief Nearest cell with a given value to the cell of a position, through a search in rings of growing radius.
+uint32_t ring_search(obstacle_map<dim> const& m, vec<dim> const& p, bool site) {
+    int cols = m.cols(), rows = m.rows();
+    uint32_t c = m.cell_of(p);
+    int cx = c % cols, cy = c / cols;
+    uint32_t best = obstacle_map<dim>::none;
+    long best_d = -1;
+    auto check = [&](int x, int y) {
+        if (x < 0 or y < 0 or x >= cols or y >= rows or m.obstacle(y * cols + x) != site) return;
+        long d = long(x - cx) * (x - cx) + long(y - cy) * (y - cy);
+        uint32_t i = y * cols + x;
+        if (best_d < 0 or d < best_d or (d == best_d and i < best)) best_d = d, best = i;
+    };
+    for (int r = 0; r < std::max(cols, rows); ++r) {
+        if (best_d >= 0 and long(r) * r > best_d) break;
+        if (r == 0) check(cx, cy);
+        for (int k = -r; k < r; ++k) {
+            check(cx + k, cy - r);
+            check(cx + r, cy + k);
+            check(cx - k, cy + r);
+            check(cx - r, cy - k);
+        }
+    }
+    return best;
+}
+
+//! @brief The squared distance between the centres of two cells.
+long sqr_cell_distance(obstacle_map<dim> const& m, uint32_t a, uint32_t b) {
+    long dx = long(a % m.cols()) - long(b % m.cols()), dy = long(a / m.cols()) - long(b / m.cols());
+    return dx * dx + dy * dy;
+}
+
+int main() {
+    std::mt19937_64 gen(42);
+    std::uniform_real_distribution<double> ux(0, width), uy(0, height);
+    std::cout << std::setw(8) << "cell" << std::setw(12) << "cells" << std::setw(12) << "bytes"
+              << std::setw(12) << "build ms" << std::setw(12) << "write ms" << std::setw(12) << "load ms"
+              << std::setw(9) << "speedup" << std::setw(8) << "check" << std::endl;
+    for (double cell : {1.0, 0.5, 0.25, 0.125}) {
+        std::string path = "obstacle_map_benchmark.obm";
+        auto start = std::chrono::high_resolution_clock::now();
+        obstacle_map<dim> built({0, 0}, {width, height}, cell, floor_plan);
+        double tb = elapsed(start);
+        start = std::chrono::high_resolution_clock::now();
+        built.write(path, 42);
+        double tw = elapsed(start);
+        start = std::chrono::high_resolution_clock::now();
+        obstacle_map<dim> loaded;
+        bool ok = loaded.load(path, 42);
+        double tl = elapsed(start);
+        std::remove(path.c_str());
+        for (size_t i = 0; ok and i < 1000; ++i) {
+            vec<dim> p = make_vec(ux(gen), uy(gen), tall);
+            ok = loaded.cell_of(p) == built.cell_of(p) and loaded.nearest_obstacle(p) == built.nearest_obstacle(p) and loaded.nearest_space(p) == built.nearest_space(p);
+        }
+        std::cout << std::setw(8) << cell << std::setw(12) << built.cols() * built.rows() << std::setw(12) << built.bytes()
+                  << std::setw(12) << std::setprecision(4) << tb * 1000 << std::setw(12) << tw * 1000 << std::setw(12) << tl * 1000
+                  << std::setw(9) << std::setprecision(3) << tb / tl << std::setw(8) << (ok ? "ok" : "error") << std::endl;
+    }
+    std::cout << std::endl;
+    obstacle_map<dim> map({0, 0}, {width, height}, 1, floor_plan);
+    std::cout << std::setw(8) << "nodes" << std::setw(8) << "rounds"
+              << std::setw(14) << "scan q/s" << std::setw(14) << "map q/s"
+              << std::setw(14) << "scan ms/rnd" << std::setw(14) << "map ms/rnd"
+              << std::setw(9) << "speedup" << std::setw(8) << "check" << std::endl;
+    for (size_t nodes : {10, 100, 1000, 10000}) {
+        size_t rounds = std::max<size_t>(100000 / nodes, 10);
+        // people walking towards random targets at 3 units per round, crossing obstacles as they go
+        std::vector<vec<dim>> pos, target;
+        for (size_t i = 0; i < nodes; ++i) {
+            pos.push_back(make_vec(ux(gen), uy(gen), tall));
+            target.push_back(make_vec(ux(gen), uy(gen), tall));
+        }
+        std::vector<std::vector<vec<dim>>> traj;
+        for (size_t t = 0; t < rounds; ++t) {
+            traj.push_back(pos);
+            for (size_t i = 0; i < nodes; ++i) {
+                double d = norm(target[i] - pos[i]);
+                if (d <= 3) pos[i] = target[i], target[i] = make_vec(ux(gen), uy(gen), tall);
+                else pos[i] = pos[i] + (target[i] - pos[i]) * (3 / d);
+            }
+        }
+        // the queries of a round: free space if on an obstacle, then the closest obstacle
+        size_t queries = 0, errors = 0;
+        std::vector<long> scan_d, map_d;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (auto const& ps : traj) for (vec<dim> const& p : ps) {
+            uint32_t c = map.cell_of(p);
+            if (map.obstacle(c)) scan_d.push_back(sqr_cell_distance(map, c, ring_search(map, p, false)));
+            scan_d.push_back(sqr_cell_distance(map, c, ring_search(map, p, true)));
+        }
+        double ts = elapsed(start);
+        start = std::chrono::high_resolution_clock::now();
+        for (auto const& ps : traj) for (vec<dim> const& p : ps) {
+            uint32_t c = map.cell_of(p);
+            if (map.is_obstacle(p)) map_d.push_back(sqr_cell_distance(map, c, map.nearest_space(p)));
+            map_d.push_back(sqr_cell_distance(map, c, map.nearest_obstacle(p)));
+        }
+        double tm = elapsed(start);
+        queries = map_d.size();
+        for (size_t i = 0; i < queries; ++i) errors += scan_d[i] != map_d[i];
+        std::cout << std::setw(8) << nodes << std::setw(8) << rounds
+                  << std::setw(14) << std::setprecision(4) << queries / ts << std::setw(14) << queries / tm
+                  << std::setw(14) << ts / rounds * 1000 << std::setw(14) << tm / rounds * 1000
+                  << std::setw(9) << std::setprecision(3) << ts / tm
+                  << std::setw(8) << (errors == 0 and scan_d.size() == queries ? "ok" : "error") << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,59 @@
+// Copyright © 2026 Giorgio Audrito. All Rights Reserved.
+
+/**
+ * @file spreading_collection_adaptive.cpp
+ * @brief Runs multiple executions of the spreading collection case study non-interactively from the command line, with an adaptive number of seeds per scenario, producing overall plots.
+ */
+
+#include "lib/adaptive_batch.hpp"
+#include "lib/spreading_collection.hpp"
+
+using namespace fcpp;
+
+int main() {
+    //! @brief Construct the plotter object.
+    option::plot_t p;
+    //! @brief The component type (batch simulator with given options).
+    using comp_t = component::batch_simulator<option::list<>>;
+    //! @brief The list of scenarios to be used for simulations (seeds are set by the adaptive runner).
+    auto init_list = batch::make_tagged_tuple_sequence(
+        batch::arithmetic<option::speed>(0, 48, 2, 10), // 25 different speeds
+        batch::arithmetic<option::dens >(5, 29, 1, 10), // 25 different densities
+        batch::arithmetic<option::hops >(1, 25, 1, 10), // 25 different hop sizes
+        batch::arithmetic<option::tvar >(0, 48, 2, 10), // 25 different time variances
+        // generate output file name for the run
+        batch::stringify<option::output>("output/spreading_collection_adaptive", "txt"),
+        // computes side length from hops
+        batch::formula<option::side, size_t>([](auto const& x) {
+            double h = common::get<option::hops>(x);
+            return h * comm / sqrt(2.0) + 0.5;
+        }),
+        // computes device number from dens and side
+        batch::formula<option::devices, size_t>([](auto const& x) {
+            double d = common::get<option::dens>(x);
+            double s = common::get<option::side>(x);
+            return d*s*s/(3.141592653589793*comm*comm) + 0.5;
+        }),
+        // creates a fresh oracle of source positions for the run
+        batch::formula<option::oracle, std::shared_ptr<position_oracle<dim>>>([](auto const&) {
+            return std::make_shared<position_oracle<dim>>();
+        }),
+        batch::constant<option::seed, option::plotter>(0, &p) // seed (overwritten) and reference to the plotter object
+    );
+    //! @brief Between 3 and 10 seeds per scenario, until the mean diameter is known within 5%.
+    batch::seed_criterion c;
+    c.min_seeds = 3;
+    c.max_seeds = 10;
+    c.rel_width = 0.05;
+    //! @brief Runs the given simulations, using the final diameter averaged over devices as statistic.
+    batch::seed_report r = batch::adaptive_run(comp_t{}, init_list, c, [](auto& network) {
+        double sum = 0;
+        device_t n = 0;
+        for (; network.node_count(n); ++n) sum += network.node_at(n).storage(option::diameter{});
+        return n > 0 ? sum / n : 0.0;
+    });
+    std::cerr << r << std::endl;
+    //! @brief Builds the resulting plots.
+    std::cout << plot::file("adaptive", p.build());
+    return 0;
+}
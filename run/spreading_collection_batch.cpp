@@ -3,17 +3,25 @@
 /**
  * @file spreading_collection_batch.cpp
  * @brief Runs multiple executions of the spreading collection case study non-interactively from the command line, producing overall plots.
+ *
+ * With the `--resume` argument, runs completed by a previous (possibly interrupted) execution are skipped.
  */
 
+#include <cstring>
+
 #include "lib/spreading_collection.hpp"
 
 using namespace fcpp;
 
-int main() {
+int main(int argc, char** argv) {
     //! @brief Construct the plotter object.
     option::plot_t p;
-    //! @brief The component type (batch simulator with given options).
-    using comp_t = component::batch_simulator<option::list>;
+    //! @brief The journal of completed runs (resumed if requested).
+    batch::run_journal<option::plot_t> journal("output/spreading_collection_batch.journal", p, argc > 1 and strcmp(argv[1], "--resume") == 0);
+    //! @brief The plot type recording rows in the journal.
+    using recorder_t = batch::run_journal<option::plot_t>::recorder;
+    //! @brief The component type (batch simulator with given options, recording rows in the journal).
+    using comp_t = component::batch_simulator<option::list<false, false, false, recorder_t>>;
     //! @brief The list of initialisation values to be used for simulations.
     auto init_list = batch::make_tagged_tuple_sequence(
         batch::arithmetic<option::seed >(0, 9, 1),      // 10 different random seeds
@@ -34,10 +42,14 @@ int main() {
             double s = common::get<option::side>(x);
             return d*s*s/(3.141592653589793*comm*comm) + 0.5;
         }),
-        batch::constant<option::plotter>(&p) // reference to the plotter object
+        // creates a fresh oracle of source positions for the run
+        batch::formula<option::oracle, std::shared_ptr<position_oracle<dim>>>([](auto const&) {
+            return std::make_shared<position_oracle<dim>>();
+        }),
+        batch::constant<option::plotter>((recorder_t*)nullptr) // set to the recorder of every run
     );
-    //! @brief Runs the given simulations.
-    batch::run(comp_t{}, init_list);
+    //! @brief Runs the given simulations not already completed.
+    batch::resumable_run(comp_t{}, init_list, journal);
     //! @brief Builds the resulting plots.
     std::cout << plot::file("batch", p.build());
     return 0;
@@ -0,0 +1,53 @@
+// Copyright © 2026 Giorgio Audrito. All Rights Reserved.
+
+/**
+ * @file spreading_collection_cached.cpp
+ * @brief Runs multiple executions of the spreading collection case study non-interactively from the command line, producing overall plots, reusing the logged rows of runs cached by previous executions.
+ *
+ * The build fingerprint covers the executable, so that cached runs are reused only by the same build.
+ */
+
+#include "lib/run_cache.hpp"
+#include "lib/spreading_collection.hpp"
+
+using namespace fcpp;
+
+int main() {
+    //! @brief Construct the plotter object.
+    option::plot_t p;
+    //! @brief The cache of runs, keyed on their parameters and the program (up to 1GB).
+    using cache_t = batch::run_cache<option::plot_t, option::seed, option::speed, option::dens, option::hops, option::tvar, option::side, option::devices>;
+    cache_t cache("output/cache", p, batch::build_fingerprint<option::list<false, false, false, void>>("spreading_collection v1"));
+    //! @brief The component type (batch simulator with given options, recording rows in the cache).
+    using comp_t = component::batch_simulator<option::list<false, false, false, cache_t::recorder>>;
+    //! @brief The list of initialisation values to be used for simulations.
+    auto init_list = batch::make_tagged_tuple_sequence(
+        batch::arithmetic<option::seed >(0, 9, 1),      // 10 different random seeds
+        batch::arithmetic<option::speed>(0, 48, 2, 10), // 25 different speeds
+        batch::arithmetic<option::dens >(5, 29, 1, 10), // 25 different densities
+        batch::arithmetic<option::hops >(1, 25, 1, 10), // 25 different hop sizes
+        batch::arithmetic<option::tvar >(0, 48, 2, 10), // 25 different time variances
+        // computes side length from hops
+        batch::formula<option::side, size_t>([](auto const& x) {
+            double h = common::get<option::hops>(x);
+            return h * comm / sqrt(2.0) + 0.5;
+        }),
+        // computes device number from dens and side
+        batch::formula<option::devices, size_t>([](auto const& x) {
+            double d = common::get<option::dens>(x);
+            double s = common::get<option::side>(x);
+            return d*s*s/(3.141592653589793*comm*comm) + 0.5;
+        }),
+        // creates a fresh oracle of source positions for the run
+        batch::formula<option::oracle, std::shared_ptr<position_oracle<dim>>>([](auto const&) {
+            return std::make_shared<position_oracle<dim>>();
+        }),
+        batch::constant<option::output, option::plotter>(nullptr, (cache_t::recorder*)nullptr) // no output file, recorder set for every run
+    );
+    //! @brief Runs the given simulations not already cached.
+    batch::cached_run(comp_t{}, init_list, cache);
+    std::cerr << cache.hits() << " runs out of " << init_list.size() << " found in cache" << std::endl;
+    //! @brief Builds the resulting plots.
+    std::cout << plot::file("cached", p.build());
+    return 0;
+}
@@ -0,0 +1,65 @@
+// Copyright © 2026 Giorgio Audrito. All Rights Reserved.
+
+/**
+ * @file spreading_collection_fusion.cpp
+ * @brief Compares rounds per second and bytes per message of the spreading collection case study, with unfused, fused and silent neighbour exchanges.
+ *
+ * Silent exchanges send the fused values in full only when they change, so they save most bytes with still devices.
+ */
+
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+
+#include "lib/spreading_collection.hpp"
+
+using namespace fcpp;
+
+//! @brief Runs a single execution with unfused, fused or silent neighbour exchanges, printing the measures.
+template <bool fused, bool silent>
+void measure(int seed, double speed) {
+    //! @brief The network object type (batch simulator with given options, emulating message sizes).
+    using net_t = typename component::batch_simulator<option::list<fused, true, false, option::plot_t, silent>>::net;
+    //! @brief The initialisation values (random seed, node movement speed, area side, number of devices, time variance, oracle of source positions).
+    auto init_v = common::make_tagged_tuple<option::seed, option::output, option::speed, option::side, option::devices, option::tvar, option::oracle>(
+        seed,
+        nullptr,
+        speed,
+        707,
+        1000,
+        10,
+        std::make_shared<position_oracle<dim>>()
+    );
+    //! @brief Construct the network object.
+    net_t network{init_v};
+    //! @brief Run the simulation until exit, measuring time.
+    auto start = std::chrono::high_resolution_clock::now();
+    network.run();
+    double t = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+    //! @brief Collects round and message size counters, and final errors of distance estimates, from the nodes.
+    size_t rounds = 0, bytes = 0, nodes = 0;
+    double error = 0;
+    for (device_t i = 0; i < 1000; ++i) if (network.node_count(i)) {
+        auto const& n = network.node_at(i);
+        rounds += n.storage(option::round_count{});
+        bytes  += n.storage(option::msg_bytes{});
+        double e = std::abs(n.storage(option::calc_distance{}) - n.storage(option::true_distance{}));
+        if (std::isfinite(e)) error += e, ++nodes;
+    }
+    std::cout << std::setw(10) << (silent ? "silent" : fused ? "fused" : "unfused") << std::setw(7) << speed << std::setw(6) << seed
+              << std::setw(14) << rounds / t
+              << std::setw(14) << double(bytes) / rounds
+              << std::setw(12) << error / nodes << std::endl;
+}
+
+int main() {
+    std::cout << std::setw(10) << "exchange" << std::setw(7) << "speed" << std::setw(6) << "seed"
+              << std::setw(14) << "rounds/s" << std::setw(14) << "bytes/msg" << std::setw(12) << "dist err" << std::endl;
+    for (double speed : {0, 10})
+        for (int seed = 0; seed < 5; ++seed) {
+            measure<false, false>(seed, speed);
+            measure<true, false>(seed, speed);
+            measure<true, true>(seed, speed);
+        }
+    return 0;
+}
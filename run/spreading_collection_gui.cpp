@@ -11,15 +11,16 @@ using namespace fcpp;
 
 int main() {
     //! @brief The network object type (interactive simulator with given options).
-    using net_t = component::interactive_simulator<option::list>::net;
-    //! @brief The initialisation values (simulation name, texture of the reference plane, node movement speed).
-    auto init_v = common::make_tagged_tuple<option::name, option::texture, option::speed, option::side, option::devices, option::tvar>(
+    using net_t = component::interactive_simulator<option::list<false, false, true>>::net;
+    //! @brief The initialisation values (simulation name, texture of the reference plane, node movement speed, oracle of source positions).
+    auto init_v = common::make_tagged_tuple<option::name, option::texture, option::speed, option::side, option::devices, option::tvar, option::oracle>(
         "Spreading-Collection Composition",
         "fcpp.png",
         25,
         2000,
         1000,
-        10
+        10,
+        std::make_shared<position_oracle<dim>>()
     );
     //! @brief Construct the network object.
     net_t network{init_v};
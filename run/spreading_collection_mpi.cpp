@@ -5,11 +5,20 @@
  * @brief Runs multiple executions of the spreading collection case study non-interactively from the command line, producing overall plots, across multiple nodes with MPI, in order to test MPI performance.
  */
 
+#include <algorithm>
 #include <chrono>
+#include <cmath>
 #include <iomanip>
+#include <memory>
+#include <mutex>
 #include <sstream>
+#include <type_traits>
 
+#include "lib/cost_schedule.hpp"
+#include "lib/plot_compare.hpp"
+#include "lib/scaling_report.hpp"
 #include "lib/spreading_collection.hpp"
+#include "lib/topology.hpp"
 
 using namespace fcpp;
 
@@ -29,6 +38,50 @@ class profiler {
     std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
 };
 
+/**
+ * @brief Clock of the local work of a process: the time from a start to the completion of its last run.
+ *
+ * Runs mark their completion when releasing their oracle of source positions, if they used it (init tuples built
+ * for other purposes, e.g. computing cost features, do not query their oracle).
+ */
+class work_clock {
+  public:
+    //! @brief Starts measuring.
+    void start() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_start = m_end = std::chrono::high_resolution_clock::now();
+    }
+
+    //! @brief The time from the start to the completion of the last run.
+    double busy() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return std::chrono::duration<double>(m_end - m_start).count();
+    }
+
+    //! @brief A fresh oracle of source positions for a run, marking the completion of the run when released.
+    std::shared_ptr<position_oracle<dim>> oracle() {
+        return std::shared_ptr<position_oracle<dim>>(new position_oracle<dim>(), [this](position_oracle<dim>* o){
+            bool used = o->hits() + o->misses() > 0;
+            delete o;
+            if (not used) return;
+            auto now = std::chrono::high_resolution_clock::now();
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_end = std::max(m_end, now);
+        });
+    }
+
+  private:
+    //! @brief The start of the measure.
+    std::chrono::high_resolution_clock::time_point m_start;
+    //! @brief The completion of the last run.
+    std::chrono::high_resolution_clock::time_point m_end;
+    //! @brief Mutex serialising the updates.
+    std::mutex m_mutex;
+};
+
+//! @brief The clock of the local work of the process.
+work_clock local_work;
+
 //! @brief Does not return an arithmetic sequence of seeds.
 inline auto maybe_seeds(int max_seed, common::number_sequence<false>) {
     return batch::constant<>();
@@ -59,17 +112,39 @@ auto init_lister(option::plot_t& p, int max_seed) {
             double s = common::get<option::side>(x);
             return d*s*s/(3.141592653589793*comm*comm) + 0.5;
         }),
+        // creates a fresh oracle of source positions for the run, marking its completion
+        batch::formula<option::oracle, std::shared_ptr<position_oracle<dim>>>([](auto const&) {
+            return local_work.oracle();
+        }),
         batch::constant<option::plotter,option::output>(&p,nullptr) // reference to the plotter object
     );
 }
 
-//! @brief Checks whether two computed plots are practically identical, printing corresponding output.
+//! @brief The cost features of a run: pairwise interactions and per-device work over the whole simulation.
+struct cost_features {
+    template <typename T>
+    std::array<double, 2> operator()(T const& x) const {
+        double n = common::get<option::devices>(x);
+        return {{n * n * end_time, n * end_time}};
+    }
+};
+
+//! @brief Constant cost features, giving plain dynamic scheduling in sequence order.
+struct fifo_features {
+    template <typename T>
+    std::array<double, 1> operator()(T const&) const {
+        return {{1}};
+    }
+};
+
+//! @brief Checks whether two computed plots are practically identical (up to rounding), printing corresponding output.
 void plot_check(option::plot_t& p, option::plot_t& q) {
     std::stringstream sp, sq;
-    sp << std::setprecision(3) << plot::file("distributed_batch", p.build());
-    sq << std::setprecision(3) << plot::file("distributed_batch", q.build());
-    if (sp.str() != sq.str()) {
-        std::cerr << "Plot check failed!" << std::endl;
+    sp << std::setprecision(17) << plot::file("distributed_batch", p.build());
+    sq << std::setprecision(17) << plot::file("distributed_batch", q.build());
+    plot::comparison c = plot::compare(sp.str(), sq.str(), 1e-6);
+    if (not c) {
+        std::cerr << "Plot check failed: " << c << std::endl;
         std::cerr << "=======================================" << std::endl;
         std::cerr << sp.str();
         std::cerr << "=======================================" << std::endl;
@@ -79,7 +154,7 @@ void plot_check(option::plot_t& p, option::plot_t& q) {
 }
 
 //! @brief The component type (batch simulator with given options).
-using comp_type = component::batch_simulator<option::list>;
+using comp_type = component::batch_simulator<option::list<>>;
 
 //! @brief The number of runs to average times.
 constexpr int runs = 5;
@@ -87,29 +162,54 @@ constexpr int runs = 5;
 //! @brief The rank of the master process.
 constexpr int rank_master = 0;
 
-//! @brief The number of MPI processes per node.
-constexpr int procs_per_node = 1;
+//! @brief Runs a batch not reporting its tail latency.
+template <typename F, typename S>
+inline double tail_run(F&& f, S& init_list, std::true_type) {
+    f(init_list);
+    return NAN;
+}
+
+//! @brief Runs a batch reporting its tail latency.
+template <typename F, typename S>
+inline double tail_run(F&& f, S& init_list, std::false_type) {
+    return f(init_list).tail;
+}
 
-//! @brief Runs a series of executions, storing times and checking correctness.
+//! @brief Runs a series of executions, storing times in a report and checking correctness.
 template <bool seeds_first, typename F, typename... As>
-void runner(int rank, int max_seed, option::plot_t& q, std::string s, F&& f) {
+void runner(int rank, int max_seed, option::plot_t& q, batch::scaling_report& report, std::string strategy, F&& f) {
+    std::string s = report.layout() + " " + strategy;
     if (rank == rank_master) std::cerr << "MPI " << s << ", starting " << runs << " runs." << std::endl;
-    std::vector<double> v;
+    std::vector<double> v, w;
+    std::vector<std::vector<double>> b;
     for (int i=0; i<runs; ++i) {
         batch::mpi_barrier();
         profiler t;
+        local_work.start();
         option::plot_t p;
         auto init_list = init_lister<seeds_first>(p, max_seed);
-        f(init_list);
+        double tail = tail_run(f, init_list, std::is_void<decltype(f(init_list))>{});
+        double elapsed = t;
+        // the time each process spent on its own runs, before waiting for the others and merging plots
+        std::vector<double> busy = batch::mpi_gather(local_work.busy());
         if (rank == rank_master) {
-            v.push_back(t);
-            std::cerr << "MPI " << s << " run " << i << " completed in " << double(t) << "s." << std::endl;
+            v.push_back(elapsed);
+            w.push_back(tail);
+            b.push_back(busy);
+            std::cerr << "MPI " << s << " run " << i << " completed in " << elapsed << "s";
+            if (not std::isnan(tail)) std::cerr << " (tail " << tail << "s)";
+            std::cerr << "." << std::endl;
             plot_check(p, q);
         }
     }
     if (rank == rank_master) {
         std::cout << std::endl << s << ":\n";
         for (double x : v) std::cout << x << std::endl;
+        if (not std::isnan(w[0])) {
+            std::cout << s << " tail:\n";
+            for (double x : w) std::cout << x << std::endl;
+        }
+        report.add(strategy, v, w, b);
     }
 }
 
@@ -127,19 +227,92 @@ inline void multi_print(T&& x, Ts&&... xs) {
     multi_print(xs...);
 }
 
+//! @brief Runs every scheduling strategy, with a given number of threads per process and layout name.
+void run_strategies(int rank, int n_procs, int seeds, option::plot_t& q, batch::scaling_report& report, size_t threads_per_proc, batch::cost_model<2>& model, batch::cost_model<1>& fifo) {
+    // Baselines with 1 process
+    if (n_procs == 1) {
+        runner<true >(rank, seeds, q, report, "baseline seeds-first", [=](auto init_list){
+            batch::run(comp_type{}, common::tags::dynamic_execution{threads_per_proc,1}, init_list);
+        });
+        runner<false>(rank, seeds, q, report, "baseline seeds-last", [=](auto init_list){
+            batch::run(comp_type{}, common::tags::dynamic_execution{threads_per_proc,1}, init_list);
+        });
+        runner<true >(rank, seeds, q, report, "baseline seeds-first-shuffle", [=](auto init_list){
+            auto seq = make_tagged_tuple_sequences(init_list);
+            seq.shuffle();
+            batch::run(comp_type{}, common::tags::dynamic_execution{threads_per_proc,1}, seq);
+        });
+        runner<false>(rank, seeds, q, report, "baseline seeds-last-shuffle", [=](auto init_list){
+            auto seq = make_tagged_tuple_sequences(init_list);
+            seq.shuffle();
+            batch::run(comp_type{}, common::tags::dynamic_execution{threads_per_proc,1}, seq);
+        });
+        runner<true >(rank, seeds, q, report, "baseline seeds-first-fifo", [=, &fifo](auto init_list){
+            return batch::lpt_run(comp_type{}, init_list, fifo, fifo_features{}, threads_per_proc);
+        });
+        runner<true >(rank, seeds, q, report, "baseline seeds-first-lpt", [=, &model](auto init_list){
+            return batch::lpt_run(comp_type{}, init_list, model, cost_features{}, threads_per_proc);
+        });
+    } else {
+        // MPI static seeds-first division.
+        runner<true >(rank, seeds, q, report, "static seeds-first", [=](auto init_list){
+            batch::run(comp_type{}, common::tags::distributed_execution{threads_per_proc, 1, 0.0, false}, init_list);
+        });
+        runner<false>(rank, seeds, q, report, "static seeds-last",  [=](auto init_list){
+            batch::run(comp_type{}, common::tags::distributed_execution{threads_per_proc, 1, 0.0, false}, init_list);
+        });
+        runner<true >(rank, seeds, q, report, "static seeds-shuffle", [=](auto init_list){
+            batch::run(comp_type{}, common::tags::distributed_execution{threads_per_proc, 1, 0.0, true}, init_list);
+        });
+        runner<true >(rank, seeds, q, report, "dynamic seeds-first", [=](auto init_list){
+            batch::run(comp_type{}, common::tags::distributed_execution{threads_per_proc, 1, 1.0, false}, init_list);
+        });
+        runner<false>(rank, seeds, q, report, "dynamic seeds-last", [=](auto init_list){
+            batch::run(comp_type{}, common::tags::distributed_execution{threads_per_proc, 1, 1.0, false}, init_list);
+        });
+        runner<false>(rank, seeds, q, report, "dynamic seeds-shuffle", [=](auto init_list){
+            batch::run(comp_type{}, common::tags::distributed_execution{threads_per_proc, 1, 1.0, true}, init_list);
+        });
+        runner<true >(rank, seeds, q, report, "dynamic seeds-first-fifo", [=, &fifo](auto init_list){
+            return batch::distributed_lpt_run(comp_type{}, init_list, fifo, fifo_features{}, threads_per_proc);
+        });
+        runner<true >(rank, seeds, q, report, "dynamic seeds-first-lpt", [=, &model](auto init_list){
+            return batch::distributed_lpt_run(comp_type{}, init_list, model, cost_features{}, threads_per_proc);
+        });
+    }
+}
+
 int main() {
     // Sets up MPI.
     int rank, n_procs;
     batch::mpi_init(rank, n_procs);
-    int n_nodes = n_procs / procs_per_node;
-    size_t threads_per_proc = std::thread::hardware_concurrency() / procs_per_node;
-    if (rank == rank_master)
-        multi_print("Running on ", n_nodes, " nodes, with ", threads_per_proc, " threads for each process.");
+    // Detects the NUMA layout, aiming at one process per NUMA domain (with a single process per node if not launched through MPI).
+    std::vector<batch::numa_domain> domains = batch::numa_domains();
+    int procs_per_node = batch::local_size(1);
+    int n_nodes = std::max(n_procs / procs_per_node, 1);
+    batch::numa_domain const& domain = domains[batch::local_rank(rank % procs_per_node) % domains.size()];
+    size_t threads_per_proc = std::max<size_t>(std::thread::hardware_concurrency() / procs_per_node, 1);
+    // Every process runs the same number of threads in the NUMA layout, as the smallest domain has CPUs.
+    size_t numa_threads = batch::min_among_processes(domain.cpus.size());
+    if (rank == rank_master) {
+        multi_print("Running on ", n_nodes, " nodes, with ", procs_per_node, " processes and ", domains.size(), " NUMA domains for each node.");
+        if (procs_per_node != int(domains.size()))
+            multi_print("One process per NUMA domain needs ", n_nodes * domains.size(), " processes in total (e.g. mpirun --bind-to none -np ", n_nodes * domains.size(), ").");
+    }
 
     std::vector<std::string> scaling_name = {"WEAK", "STRONG"};
     std::vector<int> scaling_seeds = {10*n_nodes, 100};
 
+    // Report of the timings, with speedup against a previous single-process execution.
+    batch::scaling_report report(n_nodes, n_procs);
+    std::string report_path = "output/spreading_collection_mpi-" + std::to_string(n_procs);
+    if (rank == rank_master and n_procs > 1 and not report.load_baselines("output/spreading_collection_mpi-1.csv"))
+        multi_print("No single-process report found: run with one process first to compute speedup and efficiency.");
+
     for (int s = 0; s < 2; ++s) {
+        // Cost model of runs, learned across the executions with longest-processing-time order.
+        batch::cost_model<2> model;
+        batch::cost_model<1> fifo;
         // Compute a reference plot, to check correctness.
         option::plot_t q;
         if (rank == rank_master) {
@@ -149,47 +322,23 @@ int main() {
             batch::run(comp_type{}, common::tags::dynamic_execution{}, init_list);
             std::cerr << "reference plot computed in " << double(t) << "s" << std::endl;
         }
-        // Baselines with 1 CPU
-        if (n_nodes == 1) {
-            runner<true >(rank, scaling_seeds[s], q, "baseline seeds-first", [=](auto init_list){
-                batch::run(comp_type{}, common::tags::dynamic_execution{threads_per_proc,1}, init_list);
-            });
-            runner<false>(rank, scaling_seeds[s], q, "baseline seeds-last", [=](auto init_list){
-                batch::run(comp_type{}, common::tags::dynamic_execution{threads_per_proc,1}, init_list);
-            });
-            runner<true >(rank, scaling_seeds[s], q, "baseline seeds-first-shuffle", [=](auto init_list){
-                auto seq = make_tagged_tuple_sequences(init_list);
-                seq.shuffle();
-                batch::run(comp_type{}, common::tags::dynamic_execution{threads_per_proc,1}, seq);
-            });
-            runner<false>(rank, scaling_seeds[s], q, "baseline seeds-last-shuffle", [=](auto init_list){
-                auto seq = make_tagged_tuple_sequences(init_list);
-                seq.shuffle();
-                batch::run(comp_type{}, common::tags::dynamic_execution{threads_per_proc,1}, seq);
-            });
-        } else {
-            // Construct the plotter object.
-            option::plot_t p;
-            // MPI static seeds-first division.
-            runner<true >(rank, scaling_seeds[s], q, "static seeds-first", [=](auto init_list){
-                batch::run(comp_type{}, common::tags::distributed_execution{threads_per_proc, 1, 0.0, false}, init_list);
-            });
-            runner<false>(rank, scaling_seeds[s], q, "static seeds-last",  [=](auto init_list){
-                batch::run(comp_type{}, common::tags::distributed_execution{threads_per_proc, 1, 0.0, false}, init_list);
-            });
-            runner<true >(rank, scaling_seeds[s], q, "static seeds-shuffle", [=](auto init_list){
-                batch::run(comp_type{}, common::tags::distributed_execution{threads_per_proc, 1, 0.0, true}, init_list);
-            });
-            runner<true >(rank, scaling_seeds[s], q, "dynamic seeds-first", [=](auto init_list){
-                batch::run(comp_type{}, common::tags::distributed_execution{threads_per_proc, 1, 1.0, false}, init_list);
-            });
-            runner<false>(rank, scaling_seeds[s], q, "dynamic seeds-last", [=](auto init_list){
-                batch::run(comp_type{}, common::tags::distributed_execution{threads_per_proc, 1, 1.0, false}, init_list);
-            });
-            runner<false>(rank, scaling_seeds[s], q, "dynamic seeds-shuffle", [=](auto init_list){
-                batch::run(comp_type{}, common::tags::distributed_execution{threads_per_proc, 1, 1.0, true}, init_list);
-            });
+        // Layout with every process bound to its NUMA domain, and one thread per CPU of the domain.
+        {
+            batch::cpu_binding binding(domain.cpus);
+            if (rank == rank_master)
+                multi_print("\nNUMA layout: ", numa_threads, " threads per process, bound to NUMA domain ", domain.id, binding.bound() ? "." : " (binding failed).");
+            report.section(scaling_name[s], s == 0, "numa", numa_threads);
+            run_strategies(rank, n_procs, scaling_seeds[s], q, report, numa_threads, model, fifo);
         }
+        // Layout with the hardware threads split evenly among unbound processes.
+        if (rank == rank_master)
+            multi_print("\nFLAT layout: ", threads_per_proc, " threads per process, unbound.");
+        report.section(scaling_name[s], s == 0, "flat", threads_per_proc);
+        run_strategies(rank, n_procs, scaling_seeds[s], q, report, threads_per_proc, model, fifo);
+    }
+    if (rank == rank_master) {
+        if (report.write(report_path)) multi_print("\nReport written to ", report_path, ".json and .csv");
+        else multi_print("\nCould not write the report to ", report_path, ".json and .csv");
     }
     batch::mpi_finalize();
     return 0;
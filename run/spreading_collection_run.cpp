@@ -11,13 +11,14 @@ using namespace fcpp;
 
 int main() {
     //! @brief The network object type (batch simulator with given options).
-    using net_t = component::batch_simulator<option::list>::net;
-    //! @brief The initialisation values (node movement speed).
-    auto init_v = common::make_tagged_tuple<option::speed, option::side, option::devices, option::tvar>(
+    using net_t = component::batch_simulator<option::list<false, false, true>>::net;
+    //! @brief The initialisation values (node movement speed, oracle of source positions).
+    auto init_v = common::make_tagged_tuple<option::speed, option::side, option::devices, option::tvar, option::oracle>(
         25,
         2000,
         1000,
-        10
+        10,
+        std::make_shared<position_oracle<dim>>()
     );
     //! @brief Construct the network object.
     net_t network{init_v};
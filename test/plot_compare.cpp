@@ -0,0 +1,34 @@
+// Copyright © 2026 Giorgio Audrito. All Rights Reserved.
+
+#include "gtest/gtest.h"
+
+#include "lib/plot_compare.hpp"
+
+using namespace fcpp;
+
+
+TEST(PlotCompareTest, Identical) {
+    plot::comparison c = plot::compare("a: 1 2.5 -3e2\nb: nan inf\n", "a: 1 2.5 -3e2\nb: nan inf\n");
+    EXPECT_TRUE(c.match);
+    EXPECT_EQ(5u, c.numbers);
+    EXPECT_EQ(0.0, c.max_error);
+}
+
+TEST(PlotCompareTest, Tolerance) {
+    EXPECT_TRUE(plot::compare("x = 0.333333333, y2 = 100", "x = 0.3333333, y2 = 1e+02").match);
+    EXPECT_TRUE(plot::compare("x = 1.0001", "x = 1", 1e-3).match);
+    EXPECT_FALSE(plot::compare("x = 1.01", "x = 1", 1e-3).match);
+    EXPECT_TRUE(plot::compare("x = 1e-15", "x = 0").match);
+    EXPECT_FALSE(plot::compare("x = inf", "x = 1e308").match);
+}
+
+TEST(PlotCompareTest, Mismatch) {
+    plot::comparison c = plot::compare("first\nx = 1 (ok)\ny = 2\n", "first\nx = 1 (ok)\ny = 3\n");
+    EXPECT_FALSE(c.match);
+    EXPECT_EQ(3u, c.line);
+    EXPECT_EQ("y = 2", c.first);
+    EXPECT_EQ("y = 3", c.second);
+    EXPECT_FALSE(plot::compare("title a\n", "title b\n").match);
+    EXPECT_FALSE(plot::compare("1 2 3", "1 2").match);
+    EXPECT_FALSE(plot::compare("", "1").match);
+}
@@ -0,0 +1,38 @@
+// Copyright © 2026 Giorgio Audrito. All Rights Reserved.
+
+#include "gtest/gtest.h"
+
+#include "lib/fcpp.hpp"
+
+#include "lib/spreading_collection.hpp"
+
+using namespace fcpp;
+
+
+//! @brief Runs the spreading collection batch scenario (with or without multithreading), returning its oracle.
+template <bool threaded>
+std::shared_ptr<position_oracle<dim>> run_scenario() {
+    using net_t = typename component::batch_simulator<option::list<false, false, threaded>>::net;
+    auto oracle = std::make_shared<position_oracle<dim>>();
+    auto init_v = common::make_tagged_tuple<option::output, option::speed, option::side, option::devices, option::tvar, option::oracle>(
+        nullptr,
+        25,
+        500,
+        100,
+        10,
+        oracle
+    );
+    net_t network{init_v};
+    network.run();
+    return oracle;
+}
+
+
+TEST(PositionOracleTest, SharedOnBatchScenario) {
+    for (auto oracle : {run_scenario<false>(), run_scenario<true>()}) {
+        // every round asks for the source position, most of them within a quantum computed by another round
+        EXPECT_LT(0u, oracle->misses());
+        EXPECT_LT(0u, oracle->hits());
+        EXPECT_LT(oracle->misses(), oracle->hits());
+    }
+}
@@ -0,0 +1,131 @@
+// Copyright © 2026 Giorgio Audrito. All Rights Reserved.
+
+#include "gtest/gtest.h"
+
+#include "lib/fcpp.hpp"
+
+#include "test/test_net.hpp"
+
+#include "lib/spreading_collection.hpp"
+
+using namespace fcpp;
+using namespace coordination::tags;
+using namespace component::tags;
+
+
+//! @brief Whether the fused, unfused and silent values match.
+struct match {};
+
+//! @brief Runs the fused, unfused and silent diameter estimates, with a source switching every 4 rounds.
+struct compare_main {
+    template <typename node_t>
+    void operator()(node_t& node, times_t) {
+        using namespace coordination;
+        int round = old(CALL, 0, [](int r){
+            return r+1;
+        });
+        bool is_source = node.uid == device_t(round / 4 % 3);
+        tuple<double, double, double> u = diameter_estimate(CALL, is_source, std::false_type{});
+        tuple<double, double, double> f = diameter_estimate(CALL, is_source, std::true_type{});
+        tuple<double, double, double> s = diameter_estimate(CALL, is_source, silent_exchange{});
+        node.storage(match{}) = u == f and f == s;
+    }
+};
+
+
+template <int O>
+DECLARE_OPTIONS(options,
+    program<compare_main>,
+    round_schedule<sequence::list<distribution::constant_n<times_t, 100>>>,
+    log_schedule<sequence::list<distribution::constant_n<times_t, 100>>>,
+    exports<
+        int, coordination::diameter_estimate_t<false>, coordination::diameter_estimate_t<true>, coordination::diameter_estimate_t<true, true>
+    >,
+    tuple_store<
+        match,  bool
+    >,
+    export_pointer<(O & 1) == 1>,
+    export_split<(O & 2) == 2>,
+    online_drop<(O & 4) == 4>,
+    parallel<(O & 8) == 8>,
+    synchronised<(O & 16) == 16>
+);
+template <int O>
+using combo = component::batch_simulator<options<O>>;
+
+
+MULTI_TEST(SpreadingCollectionTest, FusedMatchesUnfused, O, 5) {
+    test_net<combo<O>, std::tuple<bool>()> n{
+        [&](auto& node){
+            node.round_main(0.0);
+            return std::make_tuple(
+                node.storage(match{})
+            );
+        }
+    };
+    for (int i = 0; i < 16; ++i)
+        EXPECT_ROUND(n, {true, true, true});
+}
+
+
+//! @brief Number of rounds in which the fused, unfused and silent values differed.
+struct mismatches {};
+
+//! @brief Largest finite distance computed.
+struct max_distance {};
+
+//! @brief Runs the fused, unfused and silent diameter estimates on nodes apart, with a source switching every 5 seconds.
+struct spread_main {
+    template <typename node_t>
+    void operator()(node_t& node, times_t) {
+        using namespace coordination;
+        bool is_source = node.uid == device_t(int(node.current_time()) / 5 % 3);
+        tuple<double, double, double> u = diameter_estimate(CALL, is_source, std::false_type{});
+        tuple<double, double, double> f = diameter_estimate(CALL, is_source, std::true_type{});
+        tuple<double, double, double> s = diameter_estimate(CALL, is_source, silent_exchange{});
+        node.storage(mismatches{}) += not (u == f and f == s);
+        if (std::isfinite(get<0>(u))) node.storage(max_distance{}) = std::max(node.storage(max_distance{}), get<0>(u));
+    }
+};
+
+//! @brief Options for nodes spread in a strip, connected within a fixed range.
+template <bool threaded>
+DECLARE_OPTIONS(spread_options,
+    parallel<threaded>,
+    program<spread_main>,
+    exports<
+        coordination::diameter_estimate_t<false>, coordination::diameter_estimate_t<true>, coordination::diameter_estimate_t<true, true>
+    >,
+    round_schedule<sequence::periodic_n<1, 0, 1, 30>>,
+    spawn_schedule<sequence::multiple_n<20, 0>>,
+    init<x, distribution::rect_n<1, 0, 0, 200, 20>>,
+    connector<connect::fixed<40>>,
+    tuple_store<
+        mismatches,     size_t,
+        max_distance,   double
+    >
+);
+
+TEST(SpreadingCollectionTest, FusedMatchesUnfusedApart) {
+    for (bool threaded : {false, true}) {
+        size_t wrong = 0;
+        double far = 0;
+        auto check = [&](auto& network){
+            network.run();
+            for (device_t i = 0; i < 20; ++i) {
+                wrong += network.node_at(i).storage(mismatches{});
+                far = std::max(far, network.node_at(i).storage(max_distance{}));
+            }
+        };
+        if (threaded) {
+            component::batch_simulator<spread_options<true>>::net network{common::make_tagged_tuple<output>(nullptr)};
+            check(network);
+        } else {
+            component::batch_simulator<spread_options<false>>::net network{common::make_tagged_tuple<output>(nullptr)};
+            check(network);
+        }
+        // distances are nonzero, so that the fused arithmetic on them is exercised
+        EXPECT_LT(0, far);
+        EXPECT_EQ(0u, wrong);
+    }
+}
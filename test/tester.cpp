@@ -31,7 +31,8 @@ DECLARE_OPTIONS(options,
         spc_max,    double,
         mpc_max,    double,
         wmpc_max,   double,
-        ideal_max,  double
+        ideal_max,  double,
+        oracle,     std::shared_ptr<position_oracle<2>>
     >,
     export_pointer<(O & 1) == 1>,
     export_split<(O & 2) == 2>,